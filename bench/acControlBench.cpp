@@ -0,0 +1,106 @@
+// 空调控制循环微基准：对比按字符串读写模式与按枚举读写模式的每秒周期数
+// 用法: acControlBench [空调数量] [周期数]
+#include "airConditioner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// 与 SceneSimulation::airConditionerThreadFunc 相同的控制逻辑，
+// legacy 版本保留原先的 setMode("cool") / getMode() == "cool" 写法
+static double tickLegacy(const std::vector<AirConditioner *> &acs,
+                         double currentTemp, double &temperature) {
+    for (AirConditioner *ac : acs) {
+        double diff = currentTemp - ac->getTargetTemperature();
+        if (std::abs(diff) < 0.5) {
+            ac->setState(false);
+            ac->setMode("off");
+            ac->setSpeed(0);
+        } else {
+            ac->setState(true);
+            if (diff > 0) {
+                ac->setMode("cool");
+            } else {
+                ac->setMode("heat");
+            }
+            ac->setSpeed(std::min(10.0, std::max(1.0, std::abs(diff) * 2.0)));
+            if (ac->getMode() == "cool") {
+                temperature -= 0.3 * ac->getSpeed();
+            } else if (ac->getMode() == "heat") {
+                temperature += 0.3 * ac->getSpeed();
+            }
+        }
+    }
+    return temperature;
+}
+
+static double tickEnum(const std::vector<AirConditioner *> &acs,
+                       double currentTemp, double &temperature) {
+    for (AirConditioner *ac : acs) {
+        double diff = currentTemp - ac->getTargetTemperature();
+        if (std::abs(diff) < 0.5) {
+            ac->setState(false);
+            ac->setMode(AirConditionerMode::Off);
+            ac->setSpeed(0);
+        } else {
+            ac->setState(true);
+            AirConditionerMode mode =
+                diff > 0 ? AirConditionerMode::Cool : AirConditionerMode::Heat;
+            ac->setMode(mode);
+            double speed = std::min(10.0, std::max(1.0, std::abs(diff) * 2.0));
+            ac->setSpeed(speed);
+            if (mode == AirConditionerMode::Cool) {
+                temperature -= 0.3 * speed;
+            } else {
+                temperature += 0.3 * speed;
+            }
+        }
+    }
+    return temperature;
+}
+
+template <typename Tick>
+static double ticksPerSecond(const std::vector<AirConditioner *> &acs,
+                             int ticks, Tick tick, double &sink) {
+    double temperature = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        // 让当前温度在目标温度两侧摆动，三种模式都会被走到
+        double currentTemp = 25.0 + 5.0 * std::sin(t * 0.01);
+        tick(acs, currentTemp, temperature);
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    sink += temperature;
+    return ticks / elapsed.count();
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 64;
+    int ticks = argc > 2 ? std::atoi(argv[2]) : 200000;
+
+    AirConditionerContainer container(new AirConditionerFactory());
+    for (int i = 0; i < count; ++i) {
+        container.addDevice();
+    }
+    std::vector<AirConditioner *> acs = container.getDevices();
+    for (int i = 0; i < count; ++i) {
+        acs[i]->setTargetTemperature(22.0 + (i % 7));
+    }
+
+    double sink = 0;
+    // 先各跑一轮预热
+    ticksPerSecond(acs, ticks / 10, tickLegacy, sink);
+    ticksPerSecond(acs, ticks / 10, tickEnum, sink);
+    double legacy = ticksPerSecond(acs, ticks, tickLegacy, sink);
+    double typed = ticksPerSecond(acs, ticks, tickEnum, sink);
+
+    std::cout << "air conditioners: " << count << ", ticks: " << ticks
+              << "\n";
+    std::cout << "string mode: " << legacy << " ticks/s\n";
+    std::cout << "enum mode:   " << typed << " ticks/s\n";
+    std::cout << "speedup:     " << typed / legacy << "x\n";
+    return sink == 12345.678 ? 1 : 0;
+}
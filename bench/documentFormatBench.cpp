@@ -0,0 +1,107 @@
+// 文档格式微基准：对比 JSON/CBOR/MessagePack/BSON/UBJSON 下设备清单与
+// 场景配置的大小、编码与解析耗时。清单另测流式导入（streamInventory）
+// 用法: documentFormatBench [每类设备数量] [场景事件数量]
+#include "documentFormat.h"
+#include "inventoryImport.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+template <typename F> static double millis(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+static json makeInventory(int count) {
+    json sensors = json::array(), lights = json::array(),
+         airConditioners = json::array();
+    for (int i = 0; i < count; ++i) {
+        std::string suffix = std::to_string(i % 100);
+        sensors.push_back({{"id", 3 * i},
+                           {"name", "Sensor" + suffix},
+                           {"priorityLevel", i % 10},
+                           {"powerConsumption", 2.0},
+                           {"updateFrequency", 1000},
+                           {"temperature", 20.0 + i % 10},
+                           {"humidity", 50.0},
+                           {"CO2_Concentration", 400.0}});
+        lights.push_back({{"id", 3 * i + 1},
+                          {"name", "Light" + suffix},
+                          {"priorityLevel", i % 10},
+                          {"powerConsumption", 20.0},
+                          {"updateFrequency", 1000},
+                          {"lightness", double(i % 100)}});
+        airConditioners.push_back({{"id", 3 * i + 2},
+                                   {"name", "AC" + suffix},
+                                   {"priorityLevel", i % 10},
+                                   {"powerConsumption", 100.0},
+                                   {"updateFrequency", 1000},
+                                   {"targetTemperature", 24.0},
+                                   {"speed", 1.0},
+                                   {"mode", "cool"}});
+    }
+    return {{"Sensors", std::move(sensors)},
+            {"Lights", std::move(lights)},
+            {"AirConditioners", std::move(airConditioners)}};
+}
+
+static json makeScenario(int count) {
+    json events = json::array();
+    for (int i = 0; i < count; ++i) {
+        events.push_back({{"name", "event" + std::to_string(i)},
+                          {"trigger_time", i % 1440},
+                          {"delta_temperature", (i % 7) - 3.0},
+                          {"delta_humidity", 0.0},
+                          {"delta_co2", i % 5 == 0 ? 1000.0 : 0.0}});
+    }
+    return {{"target_temperature", 24.0},
+            {"target_humidity", 55.0},
+            {"events", std::move(events)}};
+}
+
+static void measure(const char *label, const json &document, bool inventory) {
+    const DocumentFormat formats[] = {
+        DocumentFormat::Json, DocumentFormat::Cbor, DocumentFormat::MessagePack,
+        DocumentFormat::Bson, DocumentFormat::Ubjson};
+    std::cout << label << "\n";
+    for (DocumentFormat format : formats) {
+        std::string bytes;
+        double encode = millis([&]() {
+            std::ostringstream out;
+            writeDocument(out, document, format);
+            bytes = out.str();
+        });
+        double parse = millis([&]() {
+            std::istringstream in(bytes);
+            readDocument(in, format);
+        });
+        std::cout << "  " << std::left << std::setw(9)
+                  << documentExtension(format) << std::right << std::setw(11)
+                  << bytes.size() << " bytes, encode " << encode
+                  << " ms, parse " << parse << " ms";
+        if (inventory) {
+            double stream = millis([&]() {
+                std::istringstream in(bytes);
+                streamInventory(in, [](DeviceType, const json &) {}, format);
+            });
+            std::cout << ", stream " << stream << " ms";
+        }
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int devices = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int events = argc > 2 ? std::atoi(argv[2]) : 100000;
+    measure(("inventory, " + std::to_string(3 * devices) + " devices").c_str(),
+            makeInventory(devices), true);
+    measure(("scenario, " + std::to_string(events) + " events").c_str(),
+            makeScenario(events), false);
+    return 0;
+}
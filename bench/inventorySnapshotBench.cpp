@@ -0,0 +1,139 @@
+// 设备清单保存/加载微基准：对比 JSON 清单、二进制快照（.hsinv）的完整加载
+// 与映射后按需读取（MappedInventory）
+// 用法: inventorySnapshotBench [每类设备数量] [临时文件目录]
+#include "inventorySnapshot.h"
+#include "mappedInventory.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+struct Inventory {
+    SensorContainer sensors{new SensorFactory()};
+    LightContainer lights{new LightFactory()};
+    AirConditionerContainer airConditioners{new AirConditionerFactory()};
+
+    // 逐个加入设备时只在结束后发布一次
+    void beginBatch() {
+        sensors.beginBatch();
+        lights.beginBatch();
+        airConditioners.beginBatch();
+    }
+    void endBatch() {
+        sensors.endBatch();
+        lights.endBatch();
+        airConditioners.endBatch();
+    }
+};
+
+template <typename F> static double millis(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 333334;
+    std::string dir = argc > 2 ? argv[2] : ".";
+    std::string jsonPath = dir + "/inventoryBench.json";
+    std::string snapshotPath = dir + "/inventoryBench.hsinv";
+
+    Inventory source;
+    source.beginBatch();
+    for (int i = 0; i < count; ++i) {
+        std::string suffix = std::to_string(i % 100);
+        source.sensors.importDevice({{"name", "Sensor" + suffix},
+                                     {"priorityLevel", i % 10},
+                                     {"powerConsumption", 2.0},
+                                     {"temperature", 20.0 + i % 10},
+                                     {"humidity", 50.0},
+                                     {"CO2_Concentration", 400.0}});
+        source.lights.importDevice({{"name", "Light" + suffix},
+                                    {"priorityLevel", i % 10},
+                                    {"powerConsumption", 20.0},
+                                    {"lightness", double(i % 100)}});
+        source.airConditioners.importDevice({{"name", "AC" + suffix},
+                                             {"priorityLevel", i % 10},
+                                             {"powerConsumption", 100.0},
+                                             {"targetTemperature", 24.0},
+                                             {"speed", 1.0}});
+    }
+    source.endBatch();
+
+    double saveJson = millis([&]() {
+        json j = {{"Sensors", source.sensors},
+                  {"Lights", source.lights},
+                  {"AirConditioners", source.airConditioners}};
+        std::ofstream out(jsonPath);
+        out << j.dump(4);
+    });
+    double saveSnapshot = millis([&]() {
+        saveInventorySnapshot(snapshotPath, source.sensors, source.lights,
+                              source.airConditioners);
+    });
+
+    Inventory fromJson;
+    double loadJson = millis([&]() {
+        std::ifstream in(jsonPath);
+        fromJson.beginBatch();
+        streamInventory(in, [&](DeviceType type, const json &device) {
+            switch (type) {
+            case DeviceType::Sensor:
+                fromJson.sensors.importDevice(device);
+                break;
+            case DeviceType::Light:
+                fromJson.lights.importDevice(device);
+                break;
+            case DeviceType::AirConditioner:
+                fromJson.airConditioners.importDevice(device);
+                break;
+            }
+        });
+        fromJson.endBatch();
+    });
+    Inventory fromSnapshot;
+    double loadSnapshot = millis([&]() {
+        loadInventorySnapshot(snapshotPath, fromSnapshot.sensors,
+                              fromSnapshot.lights,
+                              fromSnapshot.airConditioners);
+    });
+
+    // 映射打开后随机读取一部分设备，再修改其中一个
+    std::size_t mappedDevices = 0;
+    double attach = 0, reads = 0;
+    {
+        Inventory edited;
+        std::unique_ptr<MappedInventory> mapped;
+        attach = millis([&]() {
+            mapped = std::make_unique<MappedInventory>(snapshotPath);
+        });
+        int firstId = mapped->getFirstId();
+        reads = millis([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                int id = firstId + int((i * 2654435761u) % unsigned(3 * count));
+                mapped->deviceJson(id);
+            }
+            mapped->materialize(firstId, edited.sensors, edited.lights,
+                                edited.airConditioners);
+        });
+        mappedDevices = mapped->size();
+    }
+
+    std::ifstream jsonFile(jsonPath, std::ios::binary | std::ios::ate);
+    std::ifstream snapshotFile(snapshotPath, std::ios::binary | std::ios::ate);
+    std::cout << "devices: " << 3 * count << "\n";
+    std::cout << "json:     " << jsonFile.tellg() << " bytes, save "
+              << saveJson << " ms, load " << loadJson << " ms\n";
+    std::cout << "snapshot: " << snapshotFile.tellg() << " bytes, save "
+              << saveSnapshot << " ms, load " << loadSnapshot << " ms\n";
+    std::cout << "mapped:   attach " << attach << " ms, 1000 reads + 1 write "
+              << reads << " ms, " << mappedDevices << " devices left mapped\n";
+    std::remove(jsonPath.c_str());
+    std::remove(snapshotPath.c_str());
+    return fromSnapshot.sensors.getSize() == count ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+// 日志格式化微基准：同步模式下每条文本日志从调用到交给输出器的平均耗时
+// 用法: logFormatBench [记录数]
+#include "SmartLogger.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// 只统计字节数的输出器，排除控制台和文件写入的开销
+class CountingOutputter : public LogOutputter {
+public:
+    std::size_t bytes = 0;
+    void write(const std::string &message) override { bytes += message.size(); }
+};
+
+static double nanosPerRecord(SmartLogger *logger, int records) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < records; ++i) {
+        logger->log(LogLevel::DEBUG, i % 1000, "temperature sample");
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / records;
+}
+
+int main(int argc, char *argv[]) {
+    int records = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    SmartLogger *logger = SmartLogger::getInstance();
+    logger->removeOutputters();
+    auto outputter = std::make_unique<CountingOutputter>();
+    CountingOutputter *counter = outputter.get();
+    logger->addOutputter(std::move(outputter));
+
+    // 预热，让时间戳和线程号缓存建立起来
+    nanosPerRecord(logger, records / 10);
+    double wall = nanosPerRecord(logger, records);
+    logger->setTimeSource([]() { return std::string("D1 06:30:15"); });
+    double virtualTime = nanosPerRecord(logger, records);
+    logger->setTimeSource(nullptr);
+
+    std::cout << "records: " << records << "\n";
+    std::cout << "wall clock:   " << wall << " ns/record\n";
+    std::cout << "time source:  " << virtualTime << " ns/record\n";
+    return counter->bytes == 0 ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+// 设备清单导入微基准：逐个 importDevice 与线程池上分批并行创建的对比
+// 用法: parallelImportBench [每类设备数量] [工作线程数，0 表示按硬件线程数]
+#include "parallelImport.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+struct Inventory {
+    SensorContainer sensors{new SensorFactory()};
+    LightContainer lights{new LightFactory()};
+    AirConditionerContainer airConditioners{new AirConditionerFactory()};
+};
+
+template <typename F> static double millis(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+static std::string makeInventory(int count) {
+    json sensors = json::array(), lights = json::array(),
+         airConditioners = json::array();
+    for (int i = 0; i < count; ++i) {
+        std::string suffix = std::to_string(i % 100);
+        sensors.push_back({{"name", "Sensor" + suffix},
+                           {"priorityLevel", i % 10},
+                           {"powerConsumption", 2.0},
+                           {"temperature", 20.0 + i % 10},
+                           {"humidity", 50.0},
+                           {"CO2_Concentration", 400.0}});
+        lights.push_back({{"name", "Light" + suffix},
+                          {"priorityLevel", i % 10},
+                          {"powerConsumption", 20.0},
+                          {"lightness", double(i % 100)}});
+        airConditioners.push_back({{"name", "AC" + suffix},
+                                   {"priorityLevel", i % 10},
+                                   {"powerConsumption", 100.0},
+                                   {"targetTemperature", 24.0},
+                                   {"speed", 1.0}});
+    }
+    json inventory = {{"Sensors", std::move(sensors)},
+                      {"Lights", std::move(lights)},
+                      {"AirConditioners", std::move(airConditioners)}};
+    return inventory.dump(4);
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    unsigned workers = argc > 2 ? unsigned(std::atoi(argv[2])) : 0;
+    std::string text = makeInventory(count);
+
+    // 只解析不创建：并行导入在解析线程上的下限
+    double parseMs = millis([&]() {
+        std::istringstream in(text);
+        streamInventory(in, [](DeviceType, const json &) {});
+    });
+
+    Inventory serial;
+    double serialMs = millis([&]() {
+        std::istringstream in(text);
+        serial.sensors.beginBatch();
+        serial.lights.beginBatch();
+        serial.airConditioners.beginBatch();
+        streamInventory(in, [&](DeviceType type, const json &device) {
+            switch (type) {
+            case DeviceType::Sensor:
+                serial.sensors.importDevice(device);
+                break;
+            case DeviceType::Light:
+                serial.lights.importDevice(device);
+                break;
+            case DeviceType::AirConditioner:
+                serial.airConditioners.importDevice(device);
+                break;
+            }
+        });
+        serial.airConditioners.endBatch();
+        serial.lights.endBatch();
+        serial.sensors.endBatch();
+    });
+
+    ThreadPool pool(workers);
+    Inventory parallel;
+    double parallelMs = millis([&]() {
+        std::istringstream in(text);
+        importInventory(in, DocumentFormat::Json, parallel.sensors,
+                        parallel.lights, parallel.airConditioners, pool);
+    });
+
+    std::cout << "devices: " << 3 * count << ", " << text.size() << " bytes\n";
+    std::cout << "parse:    " << parseMs << " ms\n";
+    std::cout << "serial:   " << serialMs << " ms\n";
+    std::cout << "parallel: " << parallelMs << " ms (" << pool.size()
+              << " workers)\n";
+    return parallel.sensors.getSize() == count ? 0 : 1;
+}
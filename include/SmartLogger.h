@@ -6,9 +6,15 @@
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <vector>
+#include <functional>
+#include "logFormats.h"
+#include "mpscRing.h"
 
 // 日志级别枚举
 enum class LogLevel {
@@ -19,17 +25,35 @@ enum class LogLevel {
 
 std::string LogLevelToString(LogLevel level);
 
+// 追加 "YYYY-MM-DD HH:MM:SS.mmm" 形式的本地时间；同一秒内只格式化一次，
+// 之后只替换毫秒部分。二进制日志解码时也使用它，保证两种输出一致
+void appendWallTime(std::string& out, std::chrono::system_clock::time_point time);
+// 当前线程号的文本形式，每个线程只格式化一次
+const std::string& currentThreadIdText();
+
+// 异步模式下队列已满时的处理方式，ALERT 级别始终按 Block 处理
+enum class OverflowPolicy {
+    Block,  // 等待后台线程腾出空间
+    Drop,   // 丢弃新记录
+    Sample  // 每 sampleRate 条中等待写入一条，其余丢弃
+};
+
 // 抽象日志输出器基类
 class LogOutputter {
 public:
     virtual ~LogOutputter() = default;
     virtual void write(const std::string& message) = 0;
+    // 批量写入，异步模式下后台线程每批调用一次
+    virtual void writeBatch(const std::vector<std::string>& messages);
+    // 写出输出器自己缓冲的内容，默认每次写入后已刷新
+    virtual void flush() {}
 };
 
 // 控制台输出器
 class ConsoleOutputter : public LogOutputter {
 public:
     void write(const std::string& message) override;
+    void writeBatch(const std::vector<std::string>& messages) override;
 };
 
 // 文件输出器
@@ -41,32 +65,145 @@ public:
     FileOutputter(const std::string& filename);
     ~FileOutputter();
     void write(const std::string& message) override;
+    // 整批写入后只刷新一次
+    void writeBatch(const std::vector<std::string>& messages) override;
+};
+
+class BinaryLogWriter;
+
+// 一条尚未格式化的日志，异步模式下由调用线程填写、后台线程格式化
+struct LogRecord {
+    LogLevel level = LogLevel::INFO;
+    int deviceId = -1;
+    std::string message;
+    std::chrono::system_clock::time_point time;
+    std::string timeText; // 设置了时间源时由调用线程取得，否则为空
+    std::string threadId; // 调用线程的线程号文本
 };
 
 // 主日志类
 class SmartLogger {
 private:
-    static SmartLogger* instance;
+    using TimeSource = std::function<std::string()>;
+
+    static std::atomic<SmartLogger*> instance;
     static std::mutex instanceMutex;
     std::vector<std::unique_ptr<LogOutputter>> outputters;
     std::mutex loggerMutex;
-    LogLevel minLevel;
+    std::atomic<LogLevel> minLevel;
+    std::shared_ptr<const TimeSource> timeSource; // 只通过 atomic_load/store 访问
+    std::shared_ptr<BinaryLogWriter> binaryLog;   // 只通过 atomic_load/store 访问
+    std::atomic<int> textOutputterCount;
+
+    // 异步模式
+    std::unique_ptr<MpscRing<LogRecord>> ring;
+    std::atomic<bool> async;
+    OverflowPolicy overflowPolicy;
+    int sampleRate;
+    std::thread writerThread;
+    std::atomic<bool> stopping;
+    std::atomic<std::size_t> written;    // 后台线程已写出的记录数
+    std::atomic<std::uint64_t> dropped;
+    std::atomic<std::uint64_t> overflowed; // Sample 策略下遇到队列满的次数
+    std::atomic<bool> writerSleeping;
+    std::mutex writerMutex;
+    std::condition_variable writerWakeup;
+    std::condition_variable writtenChanged;
+
     SmartLogger();
-    std::string getCurrentTime();
-    std::string getThreadId();
+    std::string format(const LogRecord& record);
+    LogRecord makeRecord(LogLevel level, int deviceId);
+    void dispatch(LogRecord& record); // 交给文本输出器，按当前模式同步或异步
+    void writeSync(const LogRecord& record);
+    // 返回记录的队列位置加一，被丢弃时返回 0
+    std::size_t push(LogRecord& record, bool mustKeep);
+    void waitWritten(std::size_t count); // 等待后台线程累计写出 count 条
+    void wakeWriter();
+    void writerLoop();
 public:
     static SmartLogger* getInstance();
     void setMinLevel(LogLevel level);
+    bool isEnabled(LogLevel level) const {
+        return level >= minLevel.load(std::memory_order_relaxed);
+    }
     void addOutputter(std::unique_ptr<LogOutputter> outputter);
+    // 去掉所有文本输出器（包括默认的控制台），之后只写二进制日志时
+    // 结构化记录不再生成文本
+    void removeOutputters();
+    // 设置后每条记录同时以二进制形式写入 writer，传入空指针关闭
+    void setBinaryLog(std::shared_ptr<BinaryLogWriter> writer);
+    // 设置后时间戳取自 source（如模拟的虚拟时间），线程号固定输出为 0，
+    // 使同一输入产生的日志逐字节相同；传入空函数恢复墙钟时间
+    void setTimeSource(std::function<std::string()> source);
+
+    // 异步模式：log() 只把记录放入无锁队列，由后台线程批量格式化并写出。
+    // ALERT 记录返回前保证它及之前的记录都已写出，并刷新各输出器的缓冲
+    void enableAsync(std::size_t capacity = 8192,
+                     OverflowPolicy policy = OverflowPolicy::Block,
+                     int sampleRate = 10);
+    // 写出队列中剩余的记录后回到同步模式
+    void disableAsync();
+    bool isAsync() const { return async; }
+    // 等待此前进入队列的记录全部写出，再让各输出器写出自己的缓冲
+    void flush();
+    std::uint64_t getDroppedCount() const { return dropped; }
+
     void log(LogLevel level, int deviceId, const std::string& message);
     void log(LogLevel level, const std::string& message);
+
+    // 结构化记录：只传格式编号和参数，文本只在有文本输出器时才生成
+    template <typename... Args>
+    void logFormat(LogLevel level, int deviceId, LogFormat format,
+                   const Args&... args) {
+        if (level < minLevel) return;
+        const LogArg packed[] = {LogArg(args)...};
+        logArgs(level, deviceId, format, packed, sizeof...(Args));
+    }
+    void logArgs(LogLevel level, int deviceId, LogFormat format,
+                 const LogArg* args, std::size_t count);
 };
 
+// 编译期日志级别下限：低于它的日志宏展开为空语句，参数不会被编译进程序。
+// 0 为 DEBUG，1 为 INFO，2 为 ALERT，由 CMake 的 HOMESPHERE_LOG_MIN_LEVEL 设置
+#ifndef HOMESPHERE_LOG_MIN_LEVEL
+#define HOMESPHERE_LOG_MIN_LEVEL 0
+#endif
+
+// 先检查运行期级别，未启用时不求值消息参数
+#define HOMESPHERE_LOG_IF(level, call) \
+    do { \
+        SmartLogger* homesphereLogger_ = SmartLogger::getInstance(); \
+        if (homesphereLogger_->isEnabled(level)) homesphereLogger_->call; \
+    } while (0)
+#define HOMESPHERE_LOG_NONE() do {} while (0)
+
 // 宏定义简化调用
-#define LOG_DEBUG(deviceId, message) SmartLogger::getInstance()->log(LogLevel::DEBUG, deviceId, message)
-#define LOG_INFO(deviceId, message) SmartLogger::getInstance()->log(LogLevel::INFO, deviceId, message)
-#define LOG_ALERT(deviceId, message) SmartLogger::getInstance()->log(LogLevel::ALERT, deviceId, message)
+#if HOMESPHERE_LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(deviceId, message) HOMESPHERE_LOG_IF(LogLevel::DEBUG, log(LogLevel::DEBUG, deviceId, message))
+#define LOG_DEBUG_SYS(message) HOMESPHERE_LOG_IF(LogLevel::DEBUG, log(LogLevel::DEBUG, message))
+#define LOG_DEBUG_FMT(deviceId, format, ...) HOMESPHERE_LOG_IF(LogLevel::DEBUG, logFormat(LogLevel::DEBUG, deviceId, format, __VA_ARGS__))
+#else
+#define LOG_DEBUG(deviceId, message) HOMESPHERE_LOG_NONE()
+#define LOG_DEBUG_SYS(message) HOMESPHERE_LOG_NONE()
+#define LOG_DEBUG_FMT(deviceId, format, ...) HOMESPHERE_LOG_NONE()
+#endif
+
+#if HOMESPHERE_LOG_MIN_LEVEL <= 1
+#define LOG_INFO(deviceId, message) HOMESPHERE_LOG_IF(LogLevel::INFO, log(LogLevel::INFO, deviceId, message))
+#define LOG_INFO_SYS(message) HOMESPHERE_LOG_IF(LogLevel::INFO, log(LogLevel::INFO, message))
+#define LOG_INFO_FMT(deviceId, format, ...) HOMESPHERE_LOG_IF(LogLevel::INFO, logFormat(LogLevel::INFO, deviceId, format, __VA_ARGS__))
+#else
+#define LOG_INFO(deviceId, message) HOMESPHERE_LOG_NONE()
+#define LOG_INFO_SYS(message) HOMESPHERE_LOG_NONE()
+#define LOG_INFO_FMT(deviceId, format, ...) HOMESPHERE_LOG_NONE()
+#endif
 
-#define LOG_DEBUG_SYS(message) SmartLogger::getInstance()->log(LogLevel::DEBUG, message)
-#define LOG_INFO_SYS(message) SmartLogger::getInstance()->log(LogLevel::INFO, message)
-#define LOG_ALERT_SYS(message) SmartLogger::getInstance()->log(LogLevel::ALERT, message) 
\ No newline at end of file
+#if HOMESPHERE_LOG_MIN_LEVEL <= 2
+#define LOG_ALERT(deviceId, message) HOMESPHERE_LOG_IF(LogLevel::ALERT, log(LogLevel::ALERT, deviceId, message))
+#define LOG_ALERT_SYS(message) HOMESPHERE_LOG_IF(LogLevel::ALERT, log(LogLevel::ALERT, message))
+#define LOG_ALERT_FMT(deviceId, format, ...) HOMESPHERE_LOG_IF(LogLevel::ALERT, logFormat(LogLevel::ALERT, deviceId, format, __VA_ARGS__))
+#else
+#define LOG_ALERT(deviceId, message) HOMESPHERE_LOG_NONE()
+#define LOG_ALERT_SYS(message) HOMESPHERE_LOG_NONE()
+#define LOG_ALERT_FMT(deviceId, format, ...) HOMESPHERE_LOG_NONE()
+#endif
\ No newline at end of file
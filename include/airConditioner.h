@@ -1,22 +1,45 @@
 #pragma once
 
 #include "device.h"
+#include "devicePool.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 
-class AirConditioner : public Device {
+// 空调工作模式，以单字节保存以便原子读写
+enum class AirConditionerMode : std::uint8_t { Off, Cool, Heat };
+
+// 模式对应的 JSON/日志字符串（"off"/"cool"/"heat"），指向静态存储，不分配内存
+std::string_view toString(AirConditionerMode mode);
+// 解析模式字符串，无法识别时返回 false 且不修改 mode
+bool parseAirConditionerMode(std::string_view text, AirConditionerMode &mode);
+
+class AirConditioner final : public Device {
   private:
-    double targetTemperature;
-    double speed;
-    std::string mode; // "off", "cool", "heat"
+    std::atomic<double> targetTemperature;
+    std::atomic<double> speed;
+    std::atomic<AirConditionerMode> mode;
+
+  protected:
+    void saveFieldsToColumns() override;
+    void loadFieldsFromColumns() override;
 
   public:
+    // 列式存储中的字段下标
+    static const int TARGET_TEMPERATURE_FIELD = 0;
+    static const int SPEED_FIELD = 1;
+
     AirConditioner(std::string name, int priorityLevel, double powerConsumption,
                    double temperature, double speed, int updateFrequency = 1000)
         : Device(name, priorityLevel, powerConsumption, updateFrequency),
-          targetTemperature(temperature), speed(speed), mode("off") {};
+          targetTemperature(temperature), speed(speed),
+          mode(AirConditionerMode::Off) {};
 
     double getTargetTemperature() const;
     double getSpeed() const;
+    // 控制逻辑使用枚举接口；字符串接口保留给 JSON 与交互界面
+    AirConditionerMode getModeValue() const;
+    void setMode(AirConditionerMode mode);
     std::string getMode() const;
     void setMode(const std::string &mode);
 
@@ -30,9 +53,19 @@ class AirConditioner : public Device {
 };
 
 class AirConditionerFactory : public DeviceFactory {
+  private:
+    DevicePool<AirConditioner> pool;
+
   public:
     Device *createDevice() override;
     Device *createDevice(const json &param) override;
+    // 按已检查过的字段直接创建，二进制快照加载时使用
+    AirConditioner *create(const std::string &name, int priorityLevel,
+                           double powerConsumption, double targetTemperature,
+                           double speed, AirConditionerMode mode,
+                           int updateFrequency);
+    void destroyDevice(Device *device) override;
+    void reserve(int count) override;
 };
 
 class AirConditionerContainer : public DeviceContainer<AirConditioner> {
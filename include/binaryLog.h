@@ -0,0 +1,49 @@
+#pragma once
+
+#include "SmartLogger.h"
+#include "logFormats.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 二进制结构化日志文件。文件以 "HSLOG" 和版本号开头，之后是一串条目：
+//   格式定义  kind=1  u16 编号, u32 长度, 模板
+//   线程定义  kind=2  u32 线程序号, u32 长度, 线程号文本
+//   日志记录  kind=3  u8 级别, u16 格式编号, i32 设备id, u32 线程序号,
+//                     u8 时间类型 (0: i64 微秒墙钟时间; 1: u32 长度 + 虚拟时间文本),
+//                     u8 参数个数, 每个参数 u8 类型 + i64 / f64 / u32 长度 + 文本
+// 每种格式和每个线程在文件中第一次出现前写入一次定义，文件因此可以脱离
+// 程序单独解码。数值按本机字节序写入
+class BinaryLogWriter {
+  public:
+    explicit BinaryLogWriter(const std::string &filename);
+    ~BinaryLogWriter();
+
+    bool isOpen() const { return stream.is_open(); }
+
+    // timeText 非空时记录虚拟时间，否则记录 time。ALERT 记录写入后立即刷新
+    void write(LogLevel level, int deviceId, LogFormat format,
+               std::chrono::system_clock::time_point time,
+               const std::string &timeText, const LogArg *args,
+               std::size_t count);
+    void flush();
+
+  private:
+    std::vector<char> buffer; // stream 的缓冲区，需要比 stream 后析构
+    std::ofstream stream;
+    std::mutex streamMutex;
+    std::vector<bool> definedFormats;
+    std::uint64_t writerId; // 区分不同的写入器，线程序号按写入器分别分配
+    std::uint32_t nextThread;
+
+    std::uint32_t threadIndex(); // 需要持有 streamMutex
+};
+
+// 把二进制日志还原为与 SmartLogger 文本输出相同格式的行。
+// 文件损坏时输出已解码的部分并返回 false，error 中给出原因
+bool decodeBinaryLog(std::istream &in, std::ostream &out, std::string *error);
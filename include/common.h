@@ -10,4 +10,13 @@
 #define MIN_AIR_CONDITIONER_TEMPERATURE -20
 #define MAX_AIR_CONDITIONER_TEMPERATURE 40
 #define MIN_AIR_CONDITIONER_SPEED 0
-#define MAX_AIR_CONDITIONER_SPEED 100
\ No newline at end of file
+#define MAX_AIR_CONDITIONER_SPEED 100
+
+// 场景模拟中的设备控制参数
+#define LIGHT_ON_HOUR 18            // 晚上 18 点到 24 点开灯
+#define LIGHT_EVENING_LIGHTNESS 80
+#define AIR_CONDITIONER_DEAD_BAND 0.5 // 温差在此范围内关闭空调，避免频繁开关
+#define DEVICE_UPDATE_CHUNK 4096     // 并行批量更新时每个任务处理的设备数
+#define FLEET_BATCH_SIZE 64          // 批量模拟时每个任务推进的房间数
+#define IMPORT_CHUNK_SIZE 1024       // 并行导入时每个任务创建的设备数
+#define DEVICE_RETIRE_BATCH 64       // 已删除的设备积累到该数量（且不少于设备数）时由写者发布回收
\ No newline at end of file
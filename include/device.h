@@ -1,30 +1,86 @@
 #pragma once
 
+#include "common.h"
+#include "deviceColumns.h"
 #include "deviceParam.h"
 #include "exception.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 class Device {
+  public:
+    class IdScope;
+
   protected:
-    static int nextId;
+    static std::atomic<int> nextId;
+    static thread_local IdScope *idScope; // 当前线程生效的 IdScope
     int id;
     std::string name;
-    int priorityLevel;
-    double powerConsumption;
-    bool state;
-    int updateFrequency; // 更新频率(毫秒)
+    // 以下字段会被多个模拟线程同时读写，使用原子变量避免撕裂读，
+    // 彼此之间没有顺序要求，均以 relaxed 方式访问
+    std::atomic<int> priorityLevel;
+    std::atomic<double> powerConsumption;
+    std::atomic<bool> state;
+    std::atomic<int> updateFrequency; // 更新频率(毫秒)
+
+    // 绑定到列式存储后热点字段以列中的值为准，成员变量不再更新
+    DeviceColumnRef column;
+
+    // 私有数值字段所在位置：已绑定时为列中的元素，否则为成员本身
+    std::atomic<double> &field(int index, std::atomic<double> &member);
+    const std::atomic<double> &field(int index,
+                                     const std::atomic<double> &member) const;
+
+    // 子类在绑定/解绑时在成员与列之间拷贝自己的私有字段
+    virtual void saveFieldsToColumns() {}
+    virtual void loadFieldsFromColumns() {}
+
+    static int allocateId();
 
   public:
     Device(std::string name, int priorityLevel, double powerConsumption,
            int updateFrequency = 1000)
-        : id(nextId++), name(name), priorityLevel(priorityLevel),
+        : id(allocateId()), name(name), priorityLevel(priorityLevel),
           powerConsumption(powerConsumption), state(false),
           updateFrequency(updateFrequency) {};
 
-    virtual ~Device() = default;
+    virtual ~Device();
+
+    Device(const Device &) = delete;
+    Device &operator=(const Device &) = delete;
+
+    void bindColumns(DeviceColumnStore *store);
+    void unbindColumns();
+    bool isColumnBound() const;
 
     int getId() const;
+    // 预留 count 个连续的 id 并返回第一个，供按需创建的设备使用
+    static int reserveIds(int count);
+    // 归还 [first, end) 中未使用的预留 id，仅当此后没有再分配过 id 时成功，
+    // 否则这段 id 留空
+    static bool releaseIds(int first, int end);
+
+    // 作用域内当前线程新建的设备依次使用从 first 开始的预留 id，
+    // 不占用全局计数器。并行导入时各工作线程借此让 id 与文件顺序一致
+    class IdScope {
+      public:
+        explicit IdScope(int first);
+        ~IdScope();
+
+        IdScope(const IdScope &) = delete;
+        IdScope &operator=(const IdScope &) = delete;
+
+      private:
+        int next;
+        IdScope *previous;
+        friend class Device;
+    };
     std::string getName();
     int getPriorityLevel() const;
     double getPowerConsumption() const;
@@ -38,6 +94,7 @@ class Device {
     void setUpdateFrequency(int frequency);
 
     virtual DeviceType getDeviceType() const = 0;
+    // 单个设备的自更新；模拟中的批量更新走 deviceUpdate.h 的 updateAll
     virtual void update() = 0;
 
     virtual json toJson() const = 0;
@@ -46,22 +103,141 @@ class Device {
 class DeviceFactory {
   public:
     DeviceFactory() = default;
-    ~DeviceFactory() = default;
+    virtual ~DeviceFactory() = default;
 
     bool check(const json &param) const;
 
     virtual Device *createDevice() = 0;
     virtual Device *createDevice(const json &param) = 0;
+
+    // 释放由本工厂创建的设备，其他来源的设备直接 delete
+    virtual void destroyDevice(Device *device);
+    // 批量导入前预先准备 count 个设备所需的内存
+    virtual void reserve(int /*count*/) {}
+};
+
+// 删除设备时对数组的整理方式
+enum class RemovalMode {
+    Ordered,    // 后续设备整体前移，保持原有顺序
+    SwapAndPop, // 用末尾设备填补空位，不保持顺序
+};
+
+// 设备数据的存放方式
+enum class StorageMode {
+    Objects, // 数据保存在各设备对象内
+    Columns, // 热点字段集中保存在 DeviceColumnStore 中
+};
+
+// 容器内部设备数组的只读视图，不拷贝数据；
+// 容器发生增删或排序后失效，只适合在单次遍历中使用
+template <typename T> class DeviceRange {
+  private:
+    T *const *first;
+    T *const *last;
+
+  public:
+    DeviceRange(T *const *first, T *const *last) : first(first), last(last) {}
+
+    T *const *begin() const { return first; }
+    T *const *end() const { return last; }
+    int size() const { return static_cast<int>(last - first); }
+    bool empty() const { return first == last; }
+    T *operator[](int i) const { return first[i]; }
+};
+
+// 某一代之后被删除的设备。只有当这一代以及更早的各代都无人持有时才真正
+// 释放：更早一代的列表通过 next 持有后面的列表。链上只有被删除的设备，
+// 持有旧的一代不会连带持有之后各代的设备数组
+template <typename T> struct DeviceRetireList {
+    std::vector<T *> devices;
+    DeviceFactory *factory = nullptr;
+    // 切换存储方式前的列存储，较早删除的设备可能仍绑定在其中，
+    // 在本列表以及之前各列表的设备都释放后才删除
+    std::unique_ptr<DeviceColumnStore> columns;
+    std::shared_ptr<DeviceRetireList> next;
+
+    ~DeviceRetireList() {
+        for (T *device : devices) {
+            factory->destroyDevice(device);
+        }
+        // 逐个释放只由本节点持有的后续节点，长链也不会递归析构
+        std::shared_ptr<DeviceRetireList> node = std::move(next);
+        while (node && node.use_count() == 1) {
+            std::shared_ptr<DeviceRetireList> following = std::move(node->next);
+            node.reset();
+            node = std::move(following);
+        }
+    }
 };
 
+// 设备列表的一代（RCU 风格）。读者持有某一代期间，其中的设备对象不会被释放
+template <typename T> struct DeviceGeneration {
+    std::vector<T *> devices;
+    std::shared_ptr<DeviceRetireList<T>> retired; // 在这一代之后删除的设备
+};
+
+// 某一时刻设备列表的快照。持有期间列表本身不受容器增删和排序影响，
+// 其中被删除的设备也会延迟到快照释放后才回收。
+// 容器未变化时多次获取得到的是同一份共享数据，不会重新分配
+template <typename T> class DeviceSnapshot {
+  private:
+    std::shared_ptr<const std::vector<T *>> devices;
+
+    // 默认构造的快照没有数据，按空列表处理
+    const std::vector<T *> &list() const {
+        static const std::vector<T *> none;
+        return devices ? *devices : none;
+    }
+
+  public:
+    DeviceSnapshot() = default;
+    explicit DeviceSnapshot(std::shared_ptr<const std::vector<T *>> devices)
+        : devices(std::move(devices)) {}
+
+    typename std::vector<T *>::const_iterator begin() const {
+        return list().begin();
+    }
+    typename std::vector<T *>::const_iterator end() const {
+        return list().end();
+    }
+    int size() const { return static_cast<int>(list().size()); }
+    bool empty() const { return size() == 0; }
+    T *operator[](int i) const { return list()[i]; }
+};
+
+// 设备容器。增删、排序、扩容等写操作由 writeMutex 串行化，只修改写线程
+// 私有的数组并标记为待发布，单次增删是 O(1)。读者通过 snapshot()/forEach()
+// 取得最新的一代：有待发布的修改且写锁空闲时由读者复制出新的一代，
+// 写锁被占用（例如批量写入期间）时读取已发布的上一代，不会等待写者。
+// 复制的开销因此只随读取次数增长；读者频繁时大量写入应放在
+// beginBatch/endBatch 之间，避免中途被反复发布。
+// 被删除的设备随发布回收。没有读者时，已删除的设备积累到不少于
+// DEVICE_RETIRE_BATCH 和当前设备数后由写者自行发布，均摊仍是 O(1)。
+// getDevice、getSlot、getRange 等基于下标的接口只应在写线程中使用
 template <typename T> class DeviceContainer {
   protected:
     T **devices;
     int size;
     int capacity;
     DeviceFactory *factory;
-
-    void expand();
+    std::unordered_map<int, int> slotIndex; // 设备id -> 数组下标
+    RemovalMode removalMode;
+    DeviceColumnStore *columns; // 仅在 Columns 模式下非空
+
+    mutable std::recursive_mutex writeMutex;
+    // 以下三项由读者在持有写锁时更新，因此声明为 mutable
+    mutable std::shared_ptr<DeviceGeneration<T>> current; // 只通过 atomic_load/store 访问
+    mutable std::vector<T *> retiring; // 已从数组中移除、等待随下一次发布回收的设备
+    mutable std::atomic<bool> dirty;   // 数组有尚未发布的修改
+    int batchDepth;
+
+    void expand(int minCapacity = 0); // 至少扩到 minCapacity，默认容量翻倍
+    void reindex(int from); // 重建 [from, size) 区间的下标索引
+    void publish() const;   // 调用者需持有写锁
+    void commit();          // 标记有待发布的修改，必要时回收已删除的设备
+    void reclaim();         // 已删除的设备足够多且不在批量写入中时发布
+    // 取得最新发布的一代，必要时先发布
+    std::shared_ptr<DeviceGeneration<T>> acquire() const;
 
   public:
     DeviceContainer(DeviceFactory *factory); // Constructor
@@ -71,13 +247,34 @@ template <typename T> class DeviceContainer {
     void addDevice(T *Device);
     void addDevice(json &params);
     void addDevice(DeviceParam &params);
+    // 按单个设备的 json 参数创建并加入，流式导入时逐个调用
+    void importDevice(const json &param);
     bool findDevice(int id);
     bool removeDevice(int id);
+    int removeDevices(const std::vector<int> &ids); // 返回实际删除的数量
     Device *getDevice(int id);
+    int getSlot(int id) const; // 返回设备所在下标，不存在时返回 -1
     std::vector<T *> getDevices() const;
+    DeviceRange<T> getRange() const;
+    DeviceSnapshot<T> snapshot() const;
+    template <typename F> void forEach(F &&f) const;
     virtual void changeDevice(int id) = 0;
 
+    // 批量写入期间持有写锁，读者只看到开始前的一代，不会在中途发布
+    void beginBatch();
+    void endBatch();
+
     int getSize() const;
+    // 批量加入 count 个设备前预留数组、索引和工厂的内存
+    void reserve(int count);
+    DeviceFactory *getFactory() const { return factory; }
+
+    void setRemovalMode(RemovalMode mode);
+    RemovalMode getRemovalMode() const;
+
+    void setStorageMode(StorageMode mode);
+    StorageMode getStorageMode() const;
+    DeviceColumnStore *getColumns() const;
 
     std::vector<DeviceParam> getDeviceParams() const;
 
@@ -89,24 +286,93 @@ template <typename T> class DeviceContainer {
 // Constructor initializes the devices array and sets the size and capacity
 template <typename T>
 DeviceContainer<T>::DeviceContainer(DeviceFactory *factory)
-    : size(0), capacity(2), factory(factory) {
+    : size(0), capacity(2), factory(factory),
+      removalMode(RemovalMode::Ordered), columns(nullptr), dirty(false),
+      batchDepth(0) {
     devices = new T *[capacity];
+    publish();
 }
 
-// Destructor to delete all device objects and the array
+// Destructor to delete all device objects and the array.
+// 此时不应再有线程持有快照
 template <typename T> DeviceContainer<T>::~DeviceContainer() {
+    std::atomic_store(&current, std::shared_ptr<DeviceGeneration<T>>());
+    for (T *device : retiring) {
+        factory->destroyDevice(device);
+    }
+    retiring.clear();
     for (int i = 0; i < size; ++i) {
-        delete devices[i];
+        factory->destroyDevice(devices[i]);
     }
     delete[] devices;
     devices = nullptr;
+    delete columns; // 设备析构时已归还各自的槽位
+    columns = nullptr;
     delete factory;
     factory = nullptr;
 }
 
+// Publishes the current array as a new generation for readers
+template <typename T> void DeviceContainer<T>::publish() const {
+    dirty.store(false, std::memory_order_relaxed);
+    auto next = std::make_shared<DeviceGeneration<T>>();
+    next->devices.assign(devices, devices + size);
+    next->retired = std::make_shared<DeviceRetireList<T>>();
+    next->retired->factory = factory;
+
+    std::shared_ptr<DeviceGeneration<T>> previous = std::atomic_load(&current);
+    if (previous) {
+        // 读者只访问 devices，这里修改上一代的回收列表是安全的
+        previous->retired->devices.swap(retiring);
+        previous->retired->next = next->retired;
+    }
+    retiring.clear();
+    std::atomic_store(&current, next);
+}
+
+template <typename T> void DeviceContainer<T>::commit() {
+    dirty.store(true, std::memory_order_release);
+    reclaim();
+}
+
+// 只写不读的容器也不会一直保留已删除的设备：发布后上一代随 current 被替换
+// 而释放，其中的设备仅在仍有读者持有那一代时才延后回收
+template <typename T> void DeviceContainer<T>::reclaim() {
+    if (batchDepth == 0 &&
+        retiring.size() >= std::size_t(std::max(DEVICE_RETIRE_BATCH, size))) {
+        publish();
+    }
+}
+
+template <typename T>
+std::shared_ptr<DeviceGeneration<T>> DeviceContainer<T>::acquire() const {
+    if (dirty.load(std::memory_order_acquire) && writeMutex.try_lock()) {
+        // 同一线程在批量写入中途读取时仍返回上一代
+        if (batchDepth == 0 && dirty.load(std::memory_order_relaxed)) {
+            publish();
+        }
+        writeMutex.unlock();
+    }
+    return std::atomic_load(&current);
+}
+
+template <typename T> void DeviceContainer<T>::beginBatch() {
+    writeMutex.lock(); // 在 endBatch() 中释放
+    ++batchDepth;
+}
+
+template <typename T> void DeviceContainer<T>::endBatch() {
+    --batchDepth;
+    reclaim();
+    writeMutex.unlock();
+}
+
 // Expands the device array by doubling the capacity
-template <typename T> void DeviceContainer<T>::expand() {
+template <typename T> void DeviceContainer<T>::expand(int minCapacity) {
     capacity *= 2;
+    while (capacity < minCapacity) {
+        capacity *= 2;
+    }
     T **newDevices = new T *[capacity];
 
     // Copy the old devices into the new array
@@ -114,24 +380,27 @@ template <typename T> void DeviceContainer<T>::expand() {
         newDevices[i] = devices[i];
     }
 
-    delete[] devices;
+    delete[] devices; // 读者只访问已发布的各代，不会引用旧数组
     devices = newDevices;
 }
 
 // Adds a default device
 template <typename T> void DeviceContainer<T>::addDevice() {
-    if (size == capacity) {
-        expand();
-    }
-    devices[size++] = factory->createDevice();
+    addDevice(static_cast<T *>(factory->createDevice()));
 }
 
 // Adds a new device to the container
 template <typename T> void DeviceContainer<T>::addDevice(T *Device) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
     if (size == capacity) {
         expand(); // If the array is full, expand its size
     }
+    if (columns) {
+        Device->bindColumns(columns);
+    }
+    slotIndex[Device->getId()] = size;
     devices[size++] = Device;
+    commit();
 }
 
 template <typename T> void DeviceContainer<T>::addDevice(json &params) {
@@ -140,10 +409,23 @@ template <typename T> void DeviceContainer<T>::addDevice(json &params) {
             params, "params must be an array in addDevice(json &params)");
     }
 
-    for (const auto &item : params) {
-        T *device = static_cast<T *>(factory->createDevice(item));
-        addDevice(device);
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    factory->reserve(static_cast<int>(params.size()));
+    slotIndex.reserve(size + params.size());
+    ++batchDepth;
+    try {
+        for (const auto &item : params) {
+            T *device = static_cast<T *>(factory->createDevice(item));
+            addDevice(device);
+        }
+    } catch (...) {
+        // 出错前已加入的设备仍然保留，与逐个添加时的行为一致
+        --batchDepth;
+        commit();
+        throw;
     }
+    --batchDepth;
+    commit();
 }
 
 template <typename T> void DeviceContainer<T>::addDevice(DeviceParam &params) {
@@ -151,55 +433,188 @@ template <typename T> void DeviceContainer<T>::addDevice(DeviceParam &params) {
     addDevice(device);
 }
 
+template <typename T> void DeviceContainer<T>::reserve(int count) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    factory->reserve(count);
+    slotIndex.reserve(size + count);
+    if (size + count > capacity) {
+        expand(size + count);
+    }
+}
+
+template <typename T> void DeviceContainer<T>::importDevice(const json &param) {
+    T *device = static_cast<T *>(factory->createDevice(param));
+    addDevice(device);
+}
+
+// Rebuilds the id index for every slot from `from` to the end
+template <typename T> void DeviceContainer<T>::reindex(int from) {
+    for (int i = from; i < size; ++i) {
+        slotIndex[devices[i]->getId()] = i;
+    }
+}
+
+template <typename T> int DeviceContainer<T>::getSlot(int id) const {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    auto it = slotIndex.find(id);
+    return it == slotIndex.end() ? -1 : it->second;
+}
+
 // Gets a device by id
 template <typename T> bool DeviceContainer<T>::findDevice(int id) {
-    for (int i = 0; i < size; ++i) {
-        if (devices[i]->getId() == id) {
-            std::cout << "Found device with id " << id << "\n";
-            json j = *devices[i];
-            std::cout << j.dump(4) << "\n";
-            return true;
-        }
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    int slot = getSlot(id);
+    if (slot < 0) {
+        return false;
     }
 
-    return false;
+    std::cout << "Found device with id " << id << "\n";
+    json j = *devices[slot];
+    std::cout << j.dump(4) << "\n";
+    return true;
 }
 
 template <typename T> bool DeviceContainer<T>::removeDevice(int id) {
-    for (int i = 0; i < size; ++i) {
-        if (devices[i]->getId() == id) {
-            std::cout << "Removed device with id " << id << "\n";
-            json j = *devices[i];
-            std::cout << j.dump(4) << "\n";
-            delete devices[i];
-            for (int j = i; j < size - 1; ++j) {
-                devices[j] = devices[j + 1];
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    int slot = getSlot(id);
+    if (slot < 0) {
+        return false;
+    }
+
+    std::cout << "Removed device with id " << id << "\n";
+    json j = *devices[slot];
+    std::cout << j.dump(4) << "\n";
+    retiring.push_back(devices[slot]);
+    slotIndex.erase(id);
+    if (removalMode == RemovalMode::SwapAndPop) {
+        // 末尾设备直接搬到空位上，只需更新它一个的索引
+        devices[slot] = devices[size - 1];
+        --size;
+        if (slot < size) {
+            slotIndex[devices[slot]->getId()] = slot;
+        }
+        commit();
+        return true;
+    }
+    for (int i = slot; i < size - 1; ++i) {
+        devices[i] = devices[i + 1];
+    }
+    --size;
+    reindex(slot); // 后面的设备整体前移了一位
+    commit();
+    return true;
+}
+
+// Removes a batch of devices with a single compaction pass
+template <typename T>
+int DeviceContainer<T>::removeDevices(const std::vector<int> &ids) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    std::vector<int> holes;
+    for (int id : ids) {
+        int slot = getSlot(id);
+        if (slot < 0) {
+            continue; // 不存在或重复的id
+        }
+        retiring.push_back(devices[slot]);
+        devices[slot] = nullptr;
+        slotIndex.erase(id);
+        holes.push_back(slot);
+    }
+    if (holes.empty()) {
+        return 0;
+    }
+
+    std::sort(holes.begin(), holes.end());
+    if (removalMode == RemovalMode::SwapAndPop) {
+        // 从前往后填补空位，每次取末尾的有效设备
+        for (int hole : holes) {
+            while (size > 0 && devices[size - 1] == nullptr) {
+                --size;
+            }
+            if (hole >= size) {
+                break;
             }
+            devices[hole] = devices[size - 1];
+            slotIndex[devices[hole]->getId()] = hole;
+            --size;
+        }
+        while (size > 0 && devices[size - 1] == nullptr) {
             --size;
-            return true;
         }
+    } else {
+        // 从第一个空位开始一次性压实，保持相对顺序
+        int write = holes.front();
+        for (int read = holes.front(); read < size; ++read) {
+            if (devices[read] != nullptr) {
+                devices[write++] = devices[read];
+            }
+        }
+        size = write;
+        reindex(holes.front());
     }
-
-    return false;
+    commit();
+    return static_cast<int>(holes.size());
 }
 
 // Gets a device by id
 template <typename T> Device *DeviceContainer<T>::getDevice(int id) {
-    for (int i = 0; i < size; ++i) {
-        if (devices[i]->getId() == id) {
-            return devices[i];
-        }
-    }
-    return nullptr;
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    int slot = getSlot(id);
+    return slot < 0 ? nullptr : devices[slot];
 }
 
 // Returns the current number of devices in the container
-template <typename T> int DeviceContainer<T>::getSize() const { return size; }
+template <typename T> int DeviceContainer<T>::getSize() const {
+    return static_cast<int>(acquire()->devices.size());
+}
+
+template <typename T>
+void DeviceContainer<T>::setRemovalMode(RemovalMode mode) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    removalMode = mode;
+}
+
+template <typename T> RemovalMode DeviceContainer<T>::getRemovalMode() const {
+    return removalMode;
+}
+
+// Switches between per-object and column storage.
+// 只能在容器为空时切换：读者可能正在无锁地读取现有设备的字段，
+// 此时改变字段的存放位置会产生数据竞争。容器不为空时抛出 std::logic_error
+template <typename T>
+void DeviceContainer<T>::setStorageMode(StorageMode mode) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    if (mode == getStorageMode()) {
+        return;
+    }
+    if (size != 0) {
+        throw std::logic_error(
+            "storage mode can only be changed on an empty container");
+    }
+    if (mode == StorageMode::Columns) {
+        columns = new DeviceColumnStore();
+        return;
+    }
+    // 已删除但仍被旧的快照持有的设备还绑定在旧的列存储上，
+    // 把它交给当前一代的回收列表，随这些设备一起释放
+    publish();
+    std::atomic_load(&current)->retired->columns.reset(columns);
+    columns = nullptr;
+}
+
+template <typename T> StorageMode DeviceContainer<T>::getStorageMode() const {
+    return columns ? StorageMode::Columns : StorageMode::Objects;
+}
+
+template <typename T>
+DeviceColumnStore *DeviceContainer<T>::getColumns() const {
+    return columns;
+}
 
 template <typename T> json DeviceContainer<T>::toJson() const {
     json j = json::array();
-    for (int i = 0; i < size; ++i) {
-        j.push_back(*(devices[i])); // 自动调用 T 的 to_json
+    for (T *device : snapshot()) {
+        j.push_back(*device); // 自动调用 T 的 to_json
     }
     return j;
 }
@@ -210,14 +625,33 @@ void to_json(nlohmann::ordered_json &j, const DeviceContainer<T> &container) {
 }
 
 template <typename T> std::vector<T *> DeviceContainer<T>::getDevices() const {
-    std::vector<T *> result;
-    for (int i = 0; i < size; ++i) {
-        result.push_back(devices[i]);
+    DeviceSnapshot<T> current = snapshot();
+    return std::vector<T *>(current.begin(), current.end());
+}
+
+template <typename T> DeviceRange<T> DeviceContainer<T>::getRange() const {
+    return DeviceRange<T>(devices, devices + size);
+}
+
+template <typename T> DeviceSnapshot<T> DeviceContainer<T>::snapshot() const {
+    std::shared_ptr<DeviceGeneration<T>> generation = acquire();
+    // 别名构造：快照只暴露设备列表，但持有整代的引用
+    return DeviceSnapshot<T>(std::shared_ptr<const std::vector<T *>>(
+        generation, &generation->devices));
+}
+
+// Calls f(T *) for every device of the current generation without copying
+template <typename T>
+template <typename F>
+void DeviceContainer<T>::forEach(F &&f) const {
+    std::shared_ptr<DeviceGeneration<T>> generation = acquire();
+    for (T *device : generation->devices) {
+        f(device);
     }
-    return result;
 }
 
 template <typename T> void DeviceContainer<T>::sortDevices(int dimension) {
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
     if (size <= 1)
         return;
 
@@ -243,4 +677,6 @@ template <typename T> void DeviceContainer<T>::sortDevices(int dimension) {
     for (int i = 0; i < size; ++i) {
         devices[i] = deviceVec[i];
     }
+    reindex(0);
+    commit();
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// 列式存储中每个数据块容纳的设备数
+#define DEVICE_COLUMN_BLOCK_SIZE 1024
+// 数据块数量上限，即每个容器最多 4M 个设备
+#define DEVICE_COLUMN_MAX_BLOCKS 4096
+// 各类设备私有数值字段的最大个数（传感器有 3 个）
+#define DEVICE_COLUMN_FIELDS 3
+
+class DeviceColumnStore;
+
+// 一个数据块：同一字段的值连续存放，便于按字段顺序扫描。
+// 数据块分配后地址不再变化，设备可以长期持有指向块内槽位的引用。
+// 各列会被多个模拟线程同时读写，元素均为原子变量，批量扫描时使用
+// relaxed 方式读写，在 x86 上与普通读写开销相同
+struct DeviceColumnBlock {
+    DeviceColumnStore *owner;
+    std::atomic<bool> live[DEVICE_COLUMN_BLOCK_SIZE]; // 槽位是否被设备占用
+    std::atomic<int> id[DEVICE_COLUMN_BLOCK_SIZE];
+    std::atomic<bool> state[DEVICE_COLUMN_BLOCK_SIZE];
+    std::atomic<int> priorityLevel[DEVICE_COLUMN_BLOCK_SIZE];
+    std::atomic<double> powerConsumption[DEVICE_COLUMN_BLOCK_SIZE];
+    // 各设备类型自行约定下标，如 Light 只使用 fields[0] 存亮度
+    std::atomic<double> fields[DEVICE_COLUMN_FIELDS][DEVICE_COLUMN_BLOCK_SIZE];
+    // 一组字段需要整体读写时使用的序列号（如传感器的三项读数）
+    std::atomic<unsigned> sequence[DEVICE_COLUMN_BLOCK_SIZE];
+};
+
+// 设备在列式存储中的位置
+struct DeviceColumnRef {
+    DeviceColumnBlock *block = nullptr;
+    int index = 0;
+};
+
+// 热点字段的列式存储 (SoA)，由 DeviceContainer 在 Columns 模式下持有
+// 槽位的分配与释放可能来自不同线程（设备在最后一个快照释放时才析构），
+// 由 mutex 保护；数据块表只追加不移动，遍历数据块不需要加锁
+class DeviceColumnStore {
+  private:
+    std::atomic<DeviceColumnBlock *> blocks[DEVICE_COLUMN_MAX_BLOCKS];
+    std::atomic<int> blockCount;
+    std::atomic<int> tailUsed; // 最后一个数据块已分配到的位置
+    std::vector<DeviceColumnRef> freeSlots; // 被释放的槽位，优先复用
+    int liveCount;
+    mutable std::mutex slotMutex;
+
+  public:
+    DeviceColumnStore()
+        : blockCount(0), tailUsed(DEVICE_COLUMN_BLOCK_SIZE), liveCount(0) {}
+    ~DeviceColumnStore();
+
+    DeviceColumnStore(const DeviceColumnStore &) = delete;
+    DeviceColumnStore &operator=(const DeviceColumnStore &) = delete;
+
+    DeviceColumnRef acquire();
+    void release(DeviceColumnRef ref);
+
+    int getLiveCount() const;
+    int getBlockCount() const;
+    DeviceColumnBlock *getBlock(int i) const;
+    int getBlockUsed(int i) const; // 第 i 个数据块中已分配过的槽位数
+
+    // 依次处理每个数据块的 [0, used) 区间，未占用的槽位 live 为 false，
+    // 对全部设备写入相同值时可以直接整段写入而不必判断 live
+    template <typename F> void forEachBlock(F &&f) const {
+        int count = getBlockCount();
+        for (int i = 0; i < count; ++i) {
+            f(*getBlock(i), getBlockUsed(i));
+        }
+    }
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 单一设备类型的对象池：按块批量申请内存，释放的槽位挂到空闲链表上复用，
+// 池析构时所有块一次性归还。设备可能在读线程释放最后一个快照时才被回收，
+// 因此分配与回收都在 poolMutex 保护下进行
+template <typename T> class DevicePool {
+  private:
+    union Slot {
+        Slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Chunk {
+        Slot *begin;
+        Slot *end;
+    };
+
+    static constexpr int MIN_CHUNK_SIZE = 64;
+    static constexpr int MAX_CHUNK_SIZE = 4096;
+
+    std::vector<Chunk> chunks; // 按起始地址排序，便于判断对象归属
+    Slot *freeList;
+    int freeCount;
+    int nextChunkSize;
+    int liveCount;
+    mutable std::mutex poolMutex;
+
+    void addChunk(int count);
+
+  public:
+    DevicePool()
+        : freeList(nullptr), freeCount(0), nextChunkSize(MIN_CHUNK_SIZE),
+          liveCount(0) {}
+    ~DevicePool();
+
+    DevicePool(const DevicePool &) = delete;
+    DevicePool &operator=(const DevicePool &) = delete;
+
+    template <typename... Args> T *create(Args &&...args);
+    void destroy(T *object);
+    bool owns(const void *object) const;
+    void reserve(int count); // 预留至少 count 个空闲槽位
+
+    int getLiveCount() const {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        return liveCount;
+    }
+};
+
+template <typename T> DevicePool<T>::~DevicePool() {
+    // 对象的析构由持有者负责，这里只归还整块内存
+    for (auto &chunk : chunks) {
+        ::operator delete(static_cast<void *>(chunk.begin));
+    }
+    chunks.clear();
+    freeList = nullptr;
+    freeCount = 0;
+}
+
+template <typename T> void DevicePool<T>::addChunk(int count) {
+    Slot *begin = static_cast<Slot *>(::operator new(sizeof(Slot) * count));
+    Slot *end = begin + count;
+    for (Slot *slot = end; slot != begin;) {
+        --slot;
+        slot->next = freeList;
+        freeList = slot;
+    }
+    freeCount += count;
+    Chunk chunk{begin, end};
+    auto pos = std::upper_bound(chunks.begin(), chunks.end(), chunk,
+                                [](const Chunk &a, const Chunk &b) {
+                                    return std::less<Slot *>()(a.begin,
+                                                               b.begin);
+                                });
+    chunks.insert(pos, chunk);
+}
+
+template <typename T>
+template <typename... Args>
+T *DevicePool<T>::create(Args &&...args) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (freeList == nullptr) {
+        addChunk(nextChunkSize);
+        nextChunkSize = std::min(nextChunkSize * 2, MAX_CHUNK_SIZE);
+    }
+    Slot *slot = freeList;
+    freeList = slot->next;
+    T *object;
+    try {
+        object = new (slot->storage) T(std::forward<Args>(args)...);
+    } catch (...) {
+        slot->next = freeList;
+        freeList = slot;
+        throw;
+    }
+    --freeCount;
+    ++liveCount;
+    return object;
+}
+
+template <typename T> void DevicePool<T>::destroy(T *object) {
+    object->~T();
+    std::lock_guard<std::mutex> lock(poolMutex);
+    Slot *slot = reinterpret_cast<Slot *>(object);
+    slot->next = freeList;
+    freeList = slot;
+    ++freeCount;
+    --liveCount;
+}
+
+template <typename T> bool DevicePool<T>::owns(const void *object) const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    const Slot *p = static_cast<const Slot *>(object);
+    // 找到起始地址不大于 p 的最后一个块
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), p,
+                               [](const Slot *value, const Chunk &chunk) {
+                                   return std::less<const Slot *>()(
+                                       value, chunk.begin);
+                               });
+    if (it == chunks.begin()) {
+        return false;
+    }
+    --it;
+    return std::less<const Slot *>()(p, it->end);
+}
+
+template <typename T> void DevicePool<T>::reserve(int count) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (freeCount < count) {
+        addChunk(count - freeCount);
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "airConditioner.h"
+#include "common.h"
+#include "light.h"
+#include "sensor.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+// 一次批量更新的输入与输出，由模拟在每个控制周期填写
+struct DeviceUpdateContext {
+    double dt = 1.0;        // 本次推进的控制周期数，空调对环境的影响按周期累计
+    int minuteOfDay = 0;    // 当前模拟时刻（分钟）
+    bool emergency = false; // 紧急模式：灯光关闭，传感器与空调暂停更新
+    SensorReadings environment{}; // 环境真实值，传感器据此更新读数
+    double measuredTemperature = 0.0; // 空调控制所依据的传感器温度
+
+    // 输出：本次更新中空调对环境造成的变化，由调用者统一写回环境
+    double temperatureDelta = 0.0;
+    double humidityDelta = 0.0;
+};
+
+// 单个设备的更新规则。每种设备类型一个特化，updateAll 按容器的设备类型
+// 在编译期选定，遍历时直接调用非虚的内联函数，不经过 Device::update()
+template <typename T> struct DeviceUpdater;
+
+template <> struct DeviceUpdater<Light> {
+    static bool isOn(const DeviceUpdateContext &ctx) {
+        int hour = ctx.minuteOfDay / 60;
+        return !ctx.emergency && hour >= LIGHT_ON_HOUR && hour < 24;
+    }
+
+    static void update(Light &light, DeviceUpdateContext &ctx) {
+        bool on = isOn(ctx);
+        light.setState(on);
+        light.setLightness(on ? LIGHT_EVENING_LIGHTNESS : 0);
+    }
+};
+
+template <> struct DeviceUpdater<Sensor> {
+    static void update(Sensor &sensor, DeviceUpdateContext &ctx) {
+        if (ctx.emergency) {
+            return;
+        }
+        sensor.setReadings(ctx.environment);
+    }
+};
+
+template <> struct DeviceUpdater<AirConditioner> {
+    static void update(AirConditioner &ac, DeviceUpdateContext &ctx) {
+        if (ctx.emergency) {
+            return;
+        }
+        // 使用空调自己的目标温度，而不是全局目标温度
+        double diff = ctx.measuredTemperature - ac.getTargetTemperature();
+        if (std::abs(diff) < AIR_CONDITIONER_DEAD_BAND) {
+            // 温度在可接受范围内，关闭空调
+            ac.setState(false);
+            ac.setMode(AirConditionerMode::Off);
+            ac.setSpeed(0);
+            return;
+        }
+        ac.setState(true);
+        AirConditionerMode mode =
+            diff > 0 ? AirConditionerMode::Cool : AirConditionerMode::Heat;
+        ac.setMode(mode);
+        // 根据温差调整风速，使用更平滑的控制
+        double speed = std::min(10.0, std::max(1.0, std::abs(diff) * 2.0));
+        ac.setSpeed(speed);
+        if (mode == AirConditionerMode::Cool) {
+            ctx.temperatureDelta -= 0.3 * speed * ctx.dt;
+            ctx.humidityDelta -= 0.1 * speed * ctx.dt;
+        } else {
+            ctx.temperatureDelta += 0.3 * speed * ctx.dt;
+            ctx.humidityDelta += 0.05 * speed * ctx.dt;
+        }
+    }
+};
+
+// 通用批量内核：在一份快照上逐个应用 DeviceUpdater<T>
+template <typename T>
+void updateAll(DeviceContainer<T> &container, DeviceUpdateContext &ctx) {
+    for (T *device : container.snapshot()) {
+        DeviceUpdater<T>::update(*device, ctx);
+    }
+}
+
+// 各设备类型的批量内核。列式存储下直接按字段整段写入，不访问设备对象；
+// 否则退回通用内核
+void updateAll(LightContainer &lights, DeviceUpdateContext &ctx);
+void updateAll(SensorContainer &sensors, DeviceUpdateContext &ctx);
+void updateAll(AirConditionerContainer &acs, DeviceUpdateContext &ctx);
+
+
+// 并行批量内核：把快照按 chunkSize 切段，每段作为一个任务在 pool 上执行并
+// 各自累计对环境的影响，全部完成后按段的顺序合并，因此结果与线程数无关。
+// 列式存储下整段写入已经足够快，设备较少时也不值得分发，直接用串行内核
+template <typename Container>
+void updateAllParallel(Container &container, DeviceUpdateContext &ctx,
+                       ThreadPool &pool, int chunkSize = DEVICE_UPDATE_CHUNK) {
+    auto devices = container.snapshot();
+    if (container.getColumns() || devices.size() <= chunkSize) {
+        updateAll(container, ctx);
+        return;
+    }
+    using T = std::remove_pointer_t<decltype(devices[0])>;
+    int chunks = (devices.size() + chunkSize - 1) / chunkSize;
+    std::vector<DeviceUpdateContext> partial(chunks, ctx);
+    TaskGraph graph;
+    for (int c = 0; c < chunks; ++c) {
+        graph.add([&, c]() {
+            DeviceUpdateContext &local = partial[c];
+            local.temperatureDelta = 0.0;
+            local.humidityDelta = 0.0;
+            int end = std::min(devices.size(), (c + 1) * chunkSize);
+            for (int i = c * chunkSize; i < end; ++i) {
+                DeviceUpdater<T>::update(*devices[i], local);
+            }
+        });
+    }
+    graph.run(pool);
+    for (const DeviceUpdateContext &local : partial) {
+        ctx.temperatureDelta += local.temperatureDelta;
+        ctx.humidityDelta += local.humidityDelta;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "deviceParam.h"
+#include <istream>
+#include <ostream>
+#include <string>
+
+// 设备清单与环境配置的存储格式，均由 json.hpp 编解码，内容结构相同。
+// 二进制格式体积更小、解析更快，文本 JSON 便于手工编辑
+enum class DocumentFormat { Json, Cbor, MessagePack, Bson, Ubjson };
+
+// 各格式对应的文件后缀：.json .cbor .msgpack .bson .ubj
+const char *documentExtension(DocumentFormat format);
+
+// 按文件名后缀识别格式，没有可识别的后缀时返回 false，format 保持不变
+bool documentFormatFromName(const std::string &filename, DocumentFormat &format);
+
+// 数据目录中的文件路径：文件名带可识别的后缀时原样使用，
+// 否则补上 ".json"（与不带后缀的旧输入方式兼容）。format 为对应的格式
+std::string resolveDocumentPath(const std::string &directory,
+                                const std::string &filename,
+                                DocumentFormat &format);
+
+// SAX 解析（json::sax_parse）使用的输入格式
+json::input_format_t saxInputFormat(DocumentFormat format);
+
+// 读取整份文档，内容无效时抛出 json::parse_error。
+// 二进制格式的流需以 std::ios::binary 打开
+json readDocument(std::istream &in, DocumentFormat format);
+// 文本 JSON 按 4 空格缩进写出；BSON 的顶层必须是对象，否则抛出 json::type_error
+void writeDocument(std::ostream &out, const json &document,
+                   DocumentFormat format);
@@ -7,12 +7,12 @@
 class Event {
   public:
     static int nextId;
-    int id;
+    int id = 0;
     std::string name;
     std::chrono::system_clock::time_point timestamp;
-    int deviceId;
-    DeviceType deviceType;
-    bool state;
+    int deviceId = -1; // 事件涉及的设备，-1 表示不针对具体设备
+    DeviceType deviceType = DeviceType::Sensor;
+    bool state = false; // 设备在事件中被切换到的开关状态
 };
 
 class SensorEvent : public Event {
@@ -32,4 +32,22 @@ class AirConditionerEvent : public Event {
     double temperature;
     double targetTemperature;
     double speed;
-};
\ No newline at end of file
+};
+
+// 场景配置中的一个脚本事件，由 SceneSimulation::loadEnvironmentConfig
+// 在加载时解析并校验，触发时直接读取字段。沿用 Event 的 name、deviceId
+// 与 state：触发时把 deviceId 对应的设备切换到 state。场景按虚拟时间推进，
+// 不使用 timestamp
+class ScenarioEvent : public Event {
+  public:
+    int triggerTime = 0; // 当天首次触发的分钟
+    int period = 0;      // 当天内重复触发的间隔（分钟），0 表示只触发一次
+    int duration = 0;    // 变化分摊到的分钟数，0 表示触发时立即生效
+    double deltaTemperature = 0.0;
+    double deltaHumidity = 0.0;
+    double deltaCO2 = 0.0;
+    std::string room; // 只作用于同名房间，为空时作用于所有房间
+
+    // 字段缺失或类型、取值不合法时抛出 InvalidParameterException
+    static ScenarioEvent fromJson(const json &param);
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// 虚拟时间，单位为调度器的一个时间片（tick），时间片长度由使用者约定
+using SimTime = std::int64_t;
+
+// 模拟推进方式
+enum class SimulationPacing {
+    RealTime,         // 每个时间片对应固定的墙钟时长，按节奏执行
+    AsFastAsPossible, // 不等待，按 CPU 能力尽快执行完所有动作
+};
+
+// 离散事件调度器：按虚拟时间依次执行已安排的动作。
+// 同一时刻的动作先按 priority 从小到大，再按安排的先后顺序执行，
+// 因此执行顺序与墙钟和线程调度无关。调度器本身只在一个线程中使用，
+// 只有 stop() 可以从其他线程调用
+class EventScheduler {
+  public:
+    using Action = std::function<void()>;
+
+    EventScheduler();
+
+    // RealTime 模式下每个时间片对应 tickDuration 的墙钟时间
+    void setPacing(SimulationPacing pacing,
+                   std::chrono::microseconds tickDuration);
+    SimulationPacing getPacing() const { return pacing; }
+
+    SimTime now() const { return currentTime; }
+
+    void schedule(SimTime time, int priority, Action action);
+    // 从 start 起每隔 period 执行一次，直到 end（不含）
+    void scheduleEvery(SimTime start, SimTime period, SimTime end,
+                       int priority, Action action);
+
+    // 执行所有早于 end 的动作，返回后 now() == end（除非中途被 stop）。
+    // 返回执行的动作数
+    std::size_t runUntil(SimTime end);
+    void stop();
+    bool isStopped() const { return stopped; }
+
+    // 丢弃所有未执行的动作并把时钟归零
+    void reset();
+    std::size_t pending() const { return queue.size(); }
+
+  private:
+    struct Entry {
+        SimTime time;
+        int priority;
+        std::uint64_t sequence;
+        Action action;
+    };
+    // 用于 std::push_heap/pop_heap 的比较，使最早的动作位于堆顶
+    struct Later {
+        bool operator()(const Entry &a, const Entry &b) const;
+    };
+
+    std::vector<Entry> queue;
+    SimTime currentTime;
+    std::uint64_t nextSequence;
+    std::atomic<bool> stopped;
+    SimulationPacing pacing;
+    std::chrono::microseconds tickDuration;
+
+    void schedulePeriodic(SimTime start, SimTime period, SimTime end,
+                          int priority, std::int64_t n,
+                          std::shared_ptr<Action> action);
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "common.h"
+#include "room.h"
+#include "sceneSimulation.h"
+#include "threadPool.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 一户住宅，包含若干房间，每个房间有自己的设备容器
+class Home {
+  public:
+    explicit Home(std::string name) : name(std::move(name)) {}
+
+    // 批量模拟的房间设备不多，默认使用对象存储；设备不按顺序显示，
+    // 删除时用末尾设备填补空位
+    Room *addRoom(StorageMode storageMode = StorageMode::Objects);
+    const std::string &getName() const { return name; }
+    int getRoomCount() const { return int(rooms.size()); }
+    Room *getRoom(int i) const { return rooms[i].get(); }
+
+  private:
+    std::string name;
+    std::vector<std::unique_ptr<Room>> rooms;
+};
+
+// 一个模拟分钟内全部房间的汇总
+struct FleetTickStats {
+    int minute = 0;            // 自模拟开始的分钟数
+    double energyWh = 0.0;     // 本分钟内处于开启状态的设备耗电量
+    double comfortError = 0.0; // 各房间温度与目标温度之差的绝对值之和
+    int roomsOutOfComfort = 0; // 温差超出空调死区的房间数
+    int roomsInEmergency = 0;
+};
+
+struct FleetReport {
+    int rooms = 0;
+    std::vector<FleetTickStats> ticks;
+    double totalEnergyWh = 0.0;
+    double meanComfortError = 0.0; // 按房间和分钟平均
+    int emergencyRoomMinutes = 0;
+    double wallSeconds = 0.0;
+};
+
+// 多户住宅的集合与批量模拟驱动
+class Fleet {
+  public:
+    Home *addHome(const std::string &name);
+    // 新建 homes 户、每户 roomsPerHome 个房间，每个房间按同一份清单导入设备。
+    // 给出 pool 时各房间共用它，不再各自创建线程池
+    void populate(int homes, int roomsPerHome, json &inventory,
+                  ThreadPool *pool = nullptr);
+
+    int getHomeCount() const { return int(homes.size()); }
+    int getRoomCount() const;
+
+    // 所有房间按同一份环境配置模拟 days 天。各房间逐分钟同步推进：
+    // 每分钟把房间按 batchSize 分组，每组一个任务在 pool 上推进到下一分钟，
+    // 再由依赖全部分组的汇总任务按分组顺序合并统计，结果与线程数无关
+    FleetReport simulate(const json &envConfig, int days, ThreadPool &pool,
+                         int batchSize = FLEET_BATCH_SIZE);
+
+  private:
+    std::vector<std::unique_ptr<Home>> homes;
+};
+
+// 主菜单入口：交互式读取规模与配置文件后批量模拟并输出汇总
+void fleetSimulation();
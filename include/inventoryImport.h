@@ -0,0 +1,26 @@
+#pragma once
+
+#include "deviceParam.h"
+#include "documentFormat.h"
+#include <functional>
+#include <istream>
+
+// 一次导入中各类设备的数量
+struct InventoryCounts {
+    int sensors = 0;
+    int lights = 0;
+    int airConditioners = 0;
+};
+
+// 以 SAX 方式流式读取设备清单
+// {"Sensors": [...], "Lights": [...], "AirConditioners": [...]}，
+// 不构建整份文档：每读完一个设备元素就把它交给 onDevice，随后释放
+// （onDevice 可以直接取走其内容），内存占用只与单个设备的大小有关。
+// 设备按在文件中出现的顺序回调。
+// 清单不是对象、某段不是数组或缺少某段时抛出 InvalidParameterException，
+// 语法错误时抛出 json::parse_error；出错前已回调的设备不会撤销。
+// 其他键的值会被跳过。format 为二进制格式时同样逐个设备解析
+InventoryCounts streamInventory(
+    std::istream &in,
+    const std::function<void(DeviceType type, json &device)> &onDevice,
+    DocumentFormat format = DocumentFormat::Json);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "airConditioner.h"
+#include "inventoryImport.h"
+#include "light.h"
+#include "sensor.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 设备清单的二进制快照（.hsinv）。数值按本机字节序写入，各段 8 字节对齐：
+//   文件头     SnapshotHeader
+//   传感器段   counts[0] 条 SensorRecord
+//   灯光段     counts[1] 条 LightRecord
+//   空调段     counts[2] 条 AirConditionerRecord
+//   字符串表   设备名称依次存放，不含结尾的 0，相同名称只存一份
+// 与 JSON 清单保存的字段相同，设备 id 不保存，加载时重新分配
+const std::uint32_t INVENTORY_SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+    char magic[8]; // "HSINV" 后补 0
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint64_t counts[3];  // 依次为传感器、灯光、空调
+    std::uint64_t offsets[3]; // 各记录段相对文件开头的偏移
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+};
+
+// 各类记录共有的设备字段
+struct SnapshotDeviceFields {
+    std::uint32_t nameOffset; // 在字符串表中的偏移
+    std::uint32_t nameLength;
+    std::int32_t priorityLevel;
+    std::int32_t updateFrequency;
+    double powerConsumption;
+};
+
+struct SensorRecord {
+    SnapshotDeviceFields device;
+    double temperature;
+    double humidity;
+    double CO2_Concentration;
+};
+
+struct LightRecord {
+    SnapshotDeviceFields device;
+    double lightness;
+};
+
+struct AirConditionerRecord {
+    SnapshotDeviceFields device;
+    double targetTemperature;
+    double speed;
+    std::uint8_t mode; // AirConditionerMode
+    std::uint8_t reserved[7];
+};
+
+static_assert(sizeof(SnapshotHeader) == 80, "snapshot header layout");
+static_assert(sizeof(SensorRecord) == 48, "sensor record layout");
+static_assert(sizeof(LightRecord) == 32, "light record layout");
+static_assert(sizeof(AirConditionerRecord) == 48, "air conditioner record layout");
+
+// 快照内容的只读视图，不拷贝数据，data 需在视图使用期间保持有效。
+// 构造时校验文件头和各段边界，无效时抛出 std::runtime_error
+class InventorySnapshotView {
+  public:
+    InventorySnapshotView(const char *data, std::size_t size);
+
+    std::size_t count(DeviceType type) const;
+    SensorRecord sensor(std::size_t index) const;
+    LightRecord light(std::size_t index) const;
+    AirConditionerRecord airConditioner(std::size_t index) const;
+    // 名称越出字符串表时抛出 std::runtime_error
+    std::string_view name(const SnapshotDeviceFields &fields) const;
+
+  private:
+    const char *data;
+    SnapshotHeader header;
+};
+
+// 校验一条记录并通过工厂创建设备，取值检查与 JSON 导入相同，
+// 字段越界时抛出 InvalidParameterException
+Sensor *createFromRecord(SensorFactory &factory, const SensorRecord &record,
+                         std::string_view name);
+Light *createFromRecord(LightFactory &factory, const LightRecord &record,
+                        std::string_view name);
+AirConditioner *createFromRecord(AirConditionerFactory &factory,
+                                 const AirConditionerRecord &record,
+                                 std::string_view name);
+
+// 把三个容器中的设备写成快照，无法写入文件时抛出 std::runtime_error
+void saveInventorySnapshot(const std::string &path,
+                           const SensorContainer &sensors,
+                           const LightContainer &lights,
+                           const AirConditionerContainer &airConditioners);
+
+// 映射快照文件并立即创建其中的全部设备加入各容器（按需读取见
+// mappedInventory.h）。文件无效时抛出 std::runtime_error，字段越界时抛出
+// InvalidParameterException，出错前已加入的设备保留
+InventoryCounts loadInventorySnapshot(const std::string &path,
+                                      SensorContainer &sensors,
+                                      LightContainer &lights,
+                                      AirConditionerContainer &airConditioners);
@@ -1,12 +1,19 @@
 #pragma once
 
 #include "device.h"
+#include "devicePool.h"
 
-class Light : public Device {
+class Light final : public Device {
   private:
-    double lightness;
+    std::atomic<double> lightness;
+
+  protected:
+    void saveFieldsToColumns() override;
+    void loadFieldsFromColumns() override;
 
   public:
+    static const int LIGHTNESS_FIELD = 0; // 列式存储中的字段下标
+
     Light(std::string name, int priorityLevel, double powerConsumption,
           double lightness, int updateFrequency = 1000)
         : Device(name, priorityLevel, powerConsumption, updateFrequency), lightness(lightness) {}
@@ -21,9 +28,18 @@ class Light : public Device {
 };
 
 class LightFactory : public DeviceFactory {
+  private:
+    DevicePool<Light> pool;
+
   public:
     Device *createDevice() override;
     Device *createDevice(const json &param) override;
+    // 按已检查过的字段直接创建，二进制快照加载时使用
+    Light *create(const std::string &name, int priorityLevel,
+                  double powerConsumption, double lightness,
+                  int updateFrequency);
+    void destroyDevice(Device *device) override;
+    void reserve(int count) override;
 };
 
 class LightContainer : public DeviceContainer<Light> {
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 结构化日志的格式编号。调用处只记录编号和类型化的参数，文本在需要时才按
+// 模板生成，二进制日志中也只保存编号和参数。编号写入日志文件后含义不能再变，
+// 新格式只能追加在末尾
+enum class LogFormat : std::uint16_t {
+    Text = 0, // 普通文本日志，唯一的参数就是整条消息
+    AirConditionerState,
+    LightState,
+    SensorTemperature,
+    SensorHumidity,
+    SensorCO2,
+    EnvironmentTemperature,
+    EnvironmentHumidity,
+    EnvironmentCO2,
+    SimulationClock,
+    EventHeader,
+    EventSummary,
+    EventSummaryTimed,
+    EventDeviceState,
+    EmergencyCO2,
+    EmergencyStart,
+    EmergencyRecovery,
+    EmergencyDuration,
+    AirConditionerShutdown,
+    LightShutdown,
+    SensorShutdown,
+    SensorRestart,
+    Count,
+};
+
+// 格式模板，其中的 "{}" 依次替换为参数；未知编号返回 nullptr
+const char *logFormatPattern(LogFormat format);
+
+// 一个类型化的日志参数。浮点数按 std::to_string 的格式输出，
+// 与原先拼接字符串的结果一致
+struct LogArg {
+    enum Type : std::uint8_t { Integer = 0, Real = 1, Text = 2 };
+
+    Type type;
+    std::int64_t integer = 0;
+    double real = 0.0;
+    std::string text;
+
+    LogArg(int value) : type(Integer), integer(value) {}
+    LogArg(long value) : type(Integer), integer(value) {}
+    LogArg(long long value) : type(Integer), integer(value) {}
+    LogArg(double value) : type(Real), real(value) {}
+    LogArg(const char *value) : type(Text), text(value) {}
+    LogArg(std::string value) : type(Text), text(std::move(value)) {}
+
+    std::string toString() const;
+};
+
+// 按模板和参数生成文本，参数不足时保留多余的 "{}"
+std::string formatLogPattern(const std::string &pattern, const LogArg *args,
+                             std::size_t count);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 只读方式映射整个文件。POSIX 系统上使用 mmap，页面按需调入；
+// 其他平台退化为一次性读入内存。对象析构时解除映射
+class MappedFile {
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // 映射 path 指向的文件，失败时返回 false，原有映射保持不变
+    bool open(const std::string &path);
+    void close();
+
+    const char *data() const { return bytes ? bytes : fallback.data(); }
+    std::size_t size() const { return length; }
+
+  private:
+    const char *bytes = nullptr; // mmap 得到的地址
+    std::size_t length = 0;
+    std::vector<char> fallback;  // 不能映射时（含空文件）读入的内容
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "inventorySnapshot.h"
+#include "mappedFile.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 按需读取的设备清单：映射二进制快照（.hsinv）后直接从映射的页面读取设备，
+// 不预先创建设备对象，打开一份大清单只需要校验文件头。
+// 快照中的设备按传感器、灯光、空调的顺序占用一段预留的连续 id。
+// 映射的页面始终只读：要修改的设备先由 materialize() 单独创建为对象并
+// 加入容器（写时复制），删除的设备只在旁路表中标记为已分离
+class MappedInventory {
+  public:
+    // 文件无法打开或格式无效时抛出 std::runtime_error
+    explicit MappedInventory(const std::string &path);
+
+    MappedInventory(const MappedInventory &) = delete;
+    MappedInventory &operator=(const MappedInventory &) = delete;
+
+    // 尚未分离的设备数量
+    std::size_t count(DeviceType type) const;
+    std::size_t size() const;
+    // 清单占用的 id 段为 [getFirstId(), getFirstId() + 设备总数)
+    int getFirstId() const { return firstId; }
+
+    // id 属于本清单且尚未分离
+    bool contains(int id) const;
+    // 以下两个接口要求 contains(id)
+    DeviceType typeOf(int id) const;
+    json deviceJson(int id) const; // 与对应设备 toJson() 的格式相同
+    // 按清单顺序把某类尚未分离的设备追加到 devices 数组
+    void appendJson(DeviceType type, json &devices) const;
+
+    // 从清单中去掉，不创建对象
+    void detach(int id);
+    // 沿用预留的 id 创建设备对象加入对应容器，并从清单中分离。
+    // 记录越界时抛出 InvalidParameterException，设备仍留在清单中
+    Device *materialize(int id, SensorContainer &sensors, LightContainer &lights,
+                        AirConditionerContainer &airConditioners);
+    // 创建全部尚未分离的设备，每个容器只发布一次，返回创建的数量
+    InventoryCounts materializeAll(SensorContainer &sensors,
+                                   LightContainer &lights,
+                                   AirConditionerContainer &airConditioners);
+
+  private:
+    MappedFile file;
+    std::unique_ptr<InventorySnapshotView> view;
+    int firstId;
+    std::size_t sectionStart[3];   // 各类设备在 id 段中的起始位置
+    std::size_t sectionCount[3];
+    std::size_t remaining[3];      // 各类尚未分离的数量
+    std::vector<bool> detached;    // 旁路表，按 id - firstId 索引
+
+    int sectionOf(std::size_t position) const;
+    Device *create(std::size_t position, SensorContainer &sensors,
+                   LightContainer &lights,
+                   AirConditionerContainer &airConditioners);
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 有界多生产者单消费者环形队列，生产者与消费者都不加锁。
+// 每个槽位带一个序列号：序列号等于写入位置时槽位可写，等于写入位置加一时
+// 槽位可读。生产者通过 CAS 抢占写入位置，抢到后写入数据再发布序列号；
+// 消费者只有一个，按顺序读取。容量向上取整为 2 的幂
+template <typename T> class MpscRing {
+  public:
+    explicit MpscRing(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        head.store(0, std::memory_order_relaxed);
+        tail = 0;
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // 队列满时返回 false，value 保持不变。成功时 position 为写入位置，
+    // 消费者读完第 position 个元素后已读数量为 position + 1
+    bool tryPush(T &value, std::size_t *position = nullptr) {
+        std::size_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell &cell = cells[pos & mask];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    if (position) {
+                        *position = pos;
+                    }
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 只能由唯一的消费者调用，队列空时返回 false
+    bool tryPop(T &value) {
+        Cell &cell = cells[tail & mask];
+        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != tail + 1) {
+            return false;
+        }
+        value = std::move(cell.value);
+        cell.sequence.store(tail + mask + 1, std::memory_order_release);
+        ++tail;
+        return true;
+    }
+
+    // 只能由消费者调用：下一个位置是否已可读
+    bool readable() const {
+        return cells[tail & mask].sequence.load(std::memory_order_acquire) ==
+               tail + 1;
+    }
+
+    // 已被生产者占用的位置数，其中可能有尚未写完的
+    std::size_t claimed() const {
+        return head.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head; // 生产者的下一个写入位置
+    alignas(64) std::size_t tail;              // 消费者的下一个读取位置
+};
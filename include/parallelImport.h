@@ -0,0 +1,23 @@
+#pragma once
+
+#include "airConditioner.h"
+#include "common.h"
+#include "inventoryImport.h"
+#include "light.h"
+#include "sensor.h"
+#include "threadPool.h"
+#include <cstddef>
+#include <istream>
+
+// 并行导入设备清单。解析仍在调用线程上按 streamInventory 顺序进行，
+// 每读满 chunkSize 个同类设备，就连同按文件顺序预留的一段 id 交给线程池，
+// 由工作线程校验并通过工厂创建，结果先放在该任务自己的批次中。
+// 解析结束后按文件顺序把各批次加入容器，每个容器只发布一次，
+// 设备 id 与加入顺序都与逐个 importDevice 相同。
+// 出错时同样保留文件中位于第一个错误之前的设备，其余已创建的设备销毁，
+// 为它们预留的 id 尽量归还（见 Device::releaseIds），随后重新抛出该错误
+InventoryCounts importInventory(std::istream &in, DocumentFormat format,
+                                SensorContainer &sensors, LightContainer &lights,
+                                AirConditionerContainer &airConditioners,
+                                ThreadPool &pool,
+                                std::size_t chunkSize = IMPORT_CHUNK_SIZE);
@@ -1,45 +1,103 @@
 #pragma once
 
 #include "airConditioner.h"
+#include "inventoryImport.h"
 #include "light.h"
+#include "mappedInventory.h"
 #include "sensor.h"
+#include "threadPool.h"
 #include "user.h"
 #include <iostream>
+#include <memory>
+#include <unordered_map>
 
 class Room {
   private:
-    LightContainer *lights;
-    SensorContainer *sensors;
-    AirConditionerContainer *airConditioners;
+    // 容器析构时一并释放各自的工厂、对象池和设备
+    std::unique_ptr<LightContainer> lights;
+    std::unique_ptr<SensorContainer> sensors;
+    std::unique_ptr<AirConditionerContainer> airConditioners;
 
-    User *currentUser;
+    User *currentUser = nullptr;
 
-    Admin* admin;
-    LightAdmin* lightAdmin;
-    SensorAdmin* sensorAdmin;
-    AirConditionerAdmin* airConditionerAdmin;
-    Visitor* visitor;
+    std::unique_ptr<Admin> admin;
+    std::unique_ptr<LightAdmin> lightAdmin;
+    std::unique_ptr<SensorAdmin> sensorAdmin;
+    std::unique_ptr<AirConditionerAdmin> airConditionerAdmin;
+    std::unique_ptr<Visitor> visitor;
+
+    std::string name; // 房间名称，场景事件可以按名称只作用于某个房间
+
+    // 设备目录：设备id -> 设备类型，查找时直接定位到所属容器，
+    // 再由容器内部的id索引得到下标
+    std::unordered_map<int, DeviceType> deviceDirectory;
+
+    // 以映射方式打开的快照清单，其中的设备在修改或模拟前才创建为对象
+    std::unique_ptr<MappedInventory> mapped;
+
+    // 设备导入与场景模拟所用的线程池，未指定时首次需要时创建房间自己的
+    ThreadPool *pool = nullptr;
+    std::unique_ptr<ThreadPool> ownedPool;
+
+    void registerDevices(DeviceType type, int from);
+    // 把映射清单中剩余的设备全部创建为对象并登记，随后释放映射
+    void materializeMapped();
+    void appendMapped(json &inventory) const;
 
   public:
     Room() {};
     ~Room() {};
 
-    void init();
+    Room(const Room &) = delete;
+    Room &operator=(const Room &) = delete;
+
+    // 模拟线程每个周期都会整体扫描设备字段，默认使用列式存储；
+    // 大量小房间批量模拟时用对象存储，避免每个容器预留数据块。
+    // 列表默认按添加顺序显示，删除时保持顺序；不关心顺序时可用 SwapAndPop
+    void init(StorageMode storageMode = StorageMode::Columns,
+              RemovalMode removalMode = RemovalMode::Ordered);
     void printCurrentUser();
     void addDevicesFromFile();
+    // 按设备清单 {"Sensors": [...], "Lights": [...], "AirConditioners": [...]}
+    // 导入设备并登记到设备目录，出错时抛出异常，已导入的设备保留
+    void loadDevices(json &inventory);
+    // 同样结构的清单，以流式方式边解析边创建设备，不构建整份文档，
+    // 设备按文件中的顺序加入。给出线程池时在其上并行创建设备（见
+    // parallelImport.h），结果与逐个导入相同。出错时抛出异常，已导入的设备保留
+    InventoryCounts loadDevices(std::istream &in,
+                                DocumentFormat format = DocumentFormat::Json,
+                                ThreadPool *pool = nullptr);
+    // 二进制快照（见 inventorySnapshot.h）的加载与保存，出错时抛出异常
+    InventoryCounts loadSnapshot(const std::string &path);
+    // 映射快照而不创建设备对象，设备在首次修改时才加入容器（见
+    // mappedInventory.h）。已有映射时先把其中的设备全部创建出来
+    InventoryCounts attachSnapshot(const std::string &path);
+    void saveSnapshot(const std::string &path);
     void addDevices();
     void showDevices();
     void findDevice();
+    // 交互式删除，一行可输入多个 id，此时按 removeDevices 批量删除
     void removeDevice();
+    int removeDevices(const std::vector<int> &ids);
     void saveDevices();
     void roomSimulation();
     void changeDevice(int id);
     void changeUser();
+
+    // 改用调用者持有的线程池，例如批量模拟中各房间共用一个
+    void setThreadPool(ThreadPool *pool) { this->pool = pool; }
+    ThreadPool *getThreadPool();
+
+    const std::string &getName() const { return name; }
+    void setName(const std::string &name) { this->name = name; }
+    // 通过设备目录一次定位设备，映射清单中的设备此时创建为对象，
+    // 不存在或无法创建时返回 nullptr
+    Device *lookupDevice(int id);
     
     // 添加getter方法以便SceneSimulation访问
-    LightContainer* getLights() const { return lights; }
-    SensorContainer* getSensors() const { return sensors; }
-    AirConditionerContainer* getAirConditioners() const { return airConditioners; }
+    LightContainer* getLights() const { return lights.get(); }
+    SensorContainer* getSensors() const { return sensors.get(); }
+    AirConditionerContainer* getAirConditioners() const { return airConditioners.get(); }
 };
 
 void menu();
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "SmartLogger.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 日志文件的滚动策略
+struct RotationPolicy {
+    std::size_t maxBytes = 64u << 20;  // 当前文件超过该大小后滚动，0 表示不按大小滚动
+    std::chrono::seconds maxAge{0};    // 当前文件打开超过该时长后滚动，0 表示不按时间滚动
+    int maxArchives = 10;              // 保留的归档段数，超出时删除最旧的，0 表示不限
+    bool buffered = false;             // 缓冲写入：缓冲区满、滚动、flush()、ALERT 或析构时才写入文件
+    std::size_t bufferBytes = 64u << 10;
+    bool compress = true;              // 在后台线程把归档段压缩为 .gz（需要 zlib）
+};
+
+// 可滚动的文件输出器。日志写入 path，滚动时当前文件按序号改名为
+// <主名>.<序号><扩展名>，例如 simulation.log -> simulation.1.log，
+// 随后由后台线程压缩为 simulation.1.log.gz 并删除原文件。
+// 析构时写出缓冲并等待所有压缩任务完成
+class RotatingFileOutputter : public LogOutputter {
+  public:
+    explicit RotatingFileOutputter(const std::string &path,
+                                   RotationPolicy policy = RotationPolicy());
+    ~RotatingFileOutputter();
+
+    void write(const std::string &message) override;
+    void writeBatch(const std::vector<std::string> &messages) override;
+    void flush() override;
+
+    // 编译时找到了 zlib 才会压缩归档段
+    static bool compressionAvailable();
+
+  private:
+    std::string path;
+    std::string stem;      // 去掉扩展名的路径
+    std::string extension; // 含 '.'，没有扩展名时为空
+    RotationPolicy policy;
+
+    std::mutex fileMutex;
+    std::ofstream fileStream;
+    std::string buffer;
+    std::size_t fileBytes; // 当前文件已写入（含缓冲中）的字节数
+    std::chrono::steady_clock::time_point openedAt;
+    int nextArchive;
+    std::deque<std::string> archives; // 已归档段压缩前的文件名，从旧到新
+
+    std::thread compressor;
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    // 归档段的后台任务：压缩或按保留数删除，按入队顺序执行，
+    // 删除因此不会与同一段的压缩交错
+    struct ArchiveJob {
+        std::string archive;
+        bool remove;
+    };
+    std::deque<ArchiveJob> jobs;
+    bool stopping;
+
+    void open();
+    void append(const std::string &message); // 需要持有 fileMutex
+    void writeBuffer();                      // 需要持有 fileMutex
+    void rotateIfNeeded();                   // 需要持有 fileMutex
+    void rotate();                           // 需要持有 fileMutex
+    void compressorLoop();
+};
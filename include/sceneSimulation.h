@@ -1,31 +1,87 @@
 #pragma once
 
+#include "event.h"
+#include "eventScheduler.h"
 #include "json.hpp"
 #include "room.h"
+#include "timingWheel.h"
+#include "threadPool.h"
 #include <atomic>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <vector>
 
 using json = nlohmann::ordered_json;
 
 class Room;
+struct DeviceUpdateContext;
 
+// 场景模拟。各项工作（环境变化、事件触发、传感器、空调控制、灯光、
+// 紧急处理、日志）作为动作安排在离散事件调度器上，按虚拟时间推进。
+// 一个时间片对应一个空调控制周期，每模拟分钟 CONTROL_STEPS_PER_MINUTE 个
 class SceneSimulation {
   public:
+    static constexpr int CONTROL_STEPS_PER_MINUTE = 20;
+    static constexpr int MINUTES_PER_DAY = 1440;
+
     SceneSimulation(Room *room);
     ~SceneSimulation();
 
-    // 加载环境与事件配置
+    // 加载环境与事件配置，按文件后缀选择格式（见 documentFormat.h），默认文本 JSON
     void loadEnvironmentConfig(const std::string &filename);
-    // 启动/停止模拟
+    // 加载已解析的配置，批量模拟时多个房间共用同一份
+    void loadEnvironmentConfig(const json &config);
+    // 推进方式，默认 RealTime：每模拟分钟 minuteMs 毫秒，一天约 144 秒
+    void setPacing(SimulationPacing pacing, int minuteMs = 100);
+    // 确定性模式：日志时间戳改用虚拟时间，同一配置的输出逐字节相同
+    void setDeterministic(bool enabled) { deterministic = enabled; }
+    // 设置后各类设备的批量更新分段在线程池上并行执行，为空时在模拟线程中串行执行
+    void setThreadPool(ThreadPool *pool) { this->pool = pool; }
+    // 不输出模拟过程的日志，批量模拟大量房间时使用
+    void setQuiet(bool enabled) { quiet = enabled; }
+    // 模拟期间把日志切换到异步模式，结束时写完剩余日志后切回
+    void setAsyncLogging(bool enabled) { asyncLogging = enabled; }
+    // 询问目标温湿度后模拟一天
     void start();
+    // 不询问用户，直接连续模拟 days 天，每天按同一组事件重复
+    void run(int days = 1);
     void stop();
 
+    // 分步推进，run(days) 即依次调用 begin(days)、advance(getEndTime())、
+    // finish()。多个模拟可以交替 advance 到同一时刻，保持同步
+    void begin(int days);
+    void advance(SimTime until); // 执行早于 until 的全部动作
+    void finish();
+    SimTime getEndTime() const { return endTime; }
+
+    // 当前环境状态
+    double getTemperature() const;
+    double getHumidity() const;
+    double getTargetTemperature() const { return targetTemperature; }
+    double getTargetHumidity() const { return targetHumidity; }
+    bool isEmergency() const { return emergencyMode; }
+
   private:
+    // 同一时刻各项工作的执行顺序
+    enum Stage {
+        EnvironmentStage,
+        EventStage,
+        SensorStage,
+        ControlStage,
+        LightStage,
+        EmergencyStage,
+        LoggingStage,
+    };
+
     Room *room;
     std::atomic<bool> running;
+    EventScheduler scheduler;
+    SimTime endTime;
+    bool deterministic;
+    ThreadPool *pool;
+    bool quiet;
+    bool asyncLogging;
+    bool ownsAsyncLogging; // 异步模式由本次模拟开启，结束时需要关闭
 
     // 环境参数
     double temperature;
@@ -36,36 +92,43 @@ class SceneSimulation {
 
     // 紧急状态管理
     std::atomic<bool> emergencyMode;
-    std::atomic<int> emergencyStartTime;             // 紧急模式开始时间（分钟）
+    std::atomic<int> emergencyStartTime; // 紧急模式开始时间（自模拟开始的分钟数）
     static const int CO2_EMERGENCY_THRESHOLD = 1000; // CO2紧急阈值
     static const int EMERGENCY_DURATION = 10;        // 紧急模式持续时间（分钟）
 
     // 事件
-    std::vector<json> events;
-    std::vector<bool> eventTriggered;
+    std::vector<ScenarioEvent> events;
+    TimingWheel eventWheel; // 按当天分钟索引 events 的下标，重复事件每次各占一项
+    // 正在分摊变化的事件
+    struct EventRamp {
+        std::size_t event;
+        int remaining; // 剩余分钟数
+    };
+    std::vector<EventRamp> ramps;
     json envConfig;
 
-    // 线程
-    std::thread envThread;
-    std::thread eventThread;
-    std::thread acThread;
-    std::thread lightThread;
-    std::thread logThread;
-    std::thread emergencyThread; // 新增紧急处理线程
-    std::thread sensorThread;    // 新增传感器线程
-
     // 互斥锁保护共享环境参数
     mutable std::mutex envMutex;
 
-    // 线程函数
-    void environmentThreadFunc();
-    void eventThreadFunc();
-    void airConditionerThreadFunc();
-    void lightThreadFunc();
-    void loggingThreadFunc();
-    void emergencyThreadFunc(); // 新增紧急处理线程函数
-    void sensorThreadFunc();    // 新增传感器线程函数
+    // 各项工作，由调度器按 Stage 顺序调用
+    void stepEnvironment();
+    void stepEvents(); // 触发本分钟的全部事件，推进分摊中的事件
+    void triggerEvent(std::size_t index);
+    void stepSensors();
+    void stepAirConditioners();
+    void stepLights();
+    void stepEmergency();
+    void logSnapshot();
+    void logDeviceStates();
+
+    // 安排一项从头到尾按 period 周期执行的工作
+    void every(SimTime period, Stage stage, void (SceneSimulation::*step)());
+    void syncClock(); // 由调度器时间更新 minuteOfDay
+    std::string virtualTimeStr() const;
+    template <typename Container>
+    void update(Container &container, DeviceUpdateContext &ctx);
 
     // 时间推进
     std::atomic<int> minuteOfDay;
+    int elapsedMinutes; // 自模拟开始经过的分钟数
 };
\ No newline at end of file
@@ -1,31 +1,55 @@
 #pragma once
 
 #include "device.h"
+#include "devicePool.h"
 
-class Sensor : public Device {
-  private:
+// 传感器的一组读数，需要整体一致地读取时使用
+struct SensorReadings {
     double temperature;
     double humidity;
     double CO2_Concentration;
+};
+
+class Sensor final : public Device {
+  private:
+    std::atomic<double> temperature;
+    std::atomic<double> humidity;
+    std::atomic<double> CO2_Concentration;
+    // 三项读数的序列锁，只允许一个线程写入读数（模拟中为传感器线程）
+    std::atomic<unsigned> readingSequence;
+
+    std::atomic<unsigned> &sequence();
+    const std::atomic<unsigned> &sequence() const;
+
+  protected:
+    void saveFieldsToColumns() override;
+    void loadFieldsFromColumns() override;
 
   public:
+    // 列式存储中的字段下标
+    static const int TEMPERATURE_FIELD = 0;
+    static const int HUMIDITY_FIELD = 1;
+    static const int CO2_FIELD = 2;
+
     Sensor(std::string name, int priorityLevel, double powerConsumption, int updateFrequency = 1000)
         : Device(name, priorityLevel, powerConsumption, updateFrequency), temperature(-1.0),
-          humidity(-1.0), CO2_Concentration(-1.0) {}
+          humidity(-1.0), CO2_Concentration(-1.0), readingSequence(0) {}
 
     Sensor(std::string name, int priorityLevel, double powerConsumption,
            double temperature, double humidity, double CO2_Concentration, int updateFrequency = 1000)
         : Device(name, priorityLevel, powerConsumption, updateFrequency),
           temperature(temperature), humidity(humidity),
-          CO2_Concentration(CO2_Concentration) {}
+          CO2_Concentration(CO2_Concentration), readingSequence(0) {}
 
     double getTemperature() const;
     double getHumidity() const;
     double getCO2_Concentration() const;
+    SensorReadings getReadings() const; // 三项读数来自同一次写入
 
     void setTemperature(double temperature);
     void setHumidity(double humidity);
     void setCO2_Concentration(double CO2_Concentration);
+    void setReadings(const SensorReadings &readings);
 
     DeviceType getDeviceType() const override;
     void update() override;
@@ -34,9 +58,18 @@ class Sensor : public Device {
 };
 
 class SensorFactory : public DeviceFactory {
+  private:
+    DevicePool<Sensor> pool;
+
   public:
     Device *createDevice() override;
     Device *createDevice(const json &param) override;
+    // 按已检查过的字段直接创建，二进制快照加载时使用
+    Sensor *create(const std::string &name, int priorityLevel,
+                   double powerConsumption, const SensorReadings &readings,
+                   int updateFrequency);
+    void destroyDevice(Device *device) override;
+    void reserve(int count) override;
 };
 
 class SensorContainer : public DeviceContainer<Sensor> {
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+
+// 单写者序列锁，用于让一组原子字段可以被整体一致地读取。
+// 写者在写入前后各把序列号加一，写入期间序列号为奇数；
+// 读者读到奇数或前后两次序列号不一致时重试。读写双方都不加锁
+
+inline void seqWriteBegin(std::atomic<unsigned> &sequence) {
+    unsigned s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void seqWriteEnd(std::atomic<unsigned> &sequence) {
+    unsigned s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s + 1, std::memory_order_release);
+}
+
+inline unsigned seqReadBegin(const std::atomic<unsigned> &sequence) {
+    unsigned s = sequence.load(std::memory_order_acquire);
+    while (s & 1) {
+        s = sequence.load(std::memory_order_acquire);
+    }
+    return s;
+}
+
+// 返回 true 表示读取期间发生了写入，需要重读
+inline bool seqReadRetry(const std::atomic<unsigned> &sequence,
+                         unsigned start) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) != start;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 共享的工作线程池。每个工作线程有自己的任务队列：从自己的队列尾部取任务，
+// 自己的队列为空时从其他线程的队列头部窃取。在工作线程内提交的任务进入
+// 该线程自己的队列，其他线程提交的任务轮流分配到各个队列
+class ThreadPool {
+  public:
+    using Task = std::function<void()>;
+
+    // workers 为 0 时按硬件线程数创建
+    explicit ThreadPool(unsigned workers = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const { return unsigned(threads.size()); }
+
+    void submit(Task task);
+    // 等待 done() 成立，期间调用线程也执行队列中的任务，
+    // 因此可以在任务内部嵌套等待而不会占满工作线程。没有任务可执行时
+    // 阻塞到有任务完成或提交。done() 在持有内部锁时调用，不能提交任务；
+    // 它应当由本线程池的任务改变，其他情况下最多延迟 1ms 才被发现
+    void waitUntil(const std::function<bool()> &done);
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> queued; // 所有队列中尚未取走的任务数
+    std::atomic<unsigned> nextQueue;
+    std::atomic<bool> stopping;
+    std::atomic<unsigned> waiting; // 阻塞在 waitUntil 中的线程数
+    std::mutex idleMutex;
+    std::condition_variable idle;
+    std::condition_variable progress; // 有任务完成或提交，唤醒 waitUntil
+
+    bool runOne(unsigned self); // 取一个任务执行，没有任务时返回 false
+    void notifyWaiters();
+    void workerLoop(unsigned index);
+};
+
+// 带依赖关系的一组任务。任务在其依赖全部完成后提交到线程池，
+// run() 阻塞到所有任务完成；任务抛出异常时，直接或间接依赖它的任务
+// 都不再执行，第一个异常在 run() 中重新抛出
+class TaskGraph {
+  public:
+    using TaskId = std::size_t;
+
+    TaskId add(ThreadPool::Task task, const std::vector<TaskId> &dependencies = {});
+    void run(ThreadPool &pool);
+    std::size_t size() const { return nodes.size(); }
+
+  private:
+    struct Node {
+        ThreadPool::Task task;
+        std::vector<TaskId> dependents;
+        int dependencies = 0;
+        std::atomic<int> remaining{0};
+        std::atomic<bool> skipped{false}; // 某个前置任务失败或被跳过
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::atomic<std::size_t> unfinished{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    void launch(ThreadPool &pool, TaskId id);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// 按时间槽分桶的触发索引，如一天 1440 个分钟槽。条目先用 add 登记，
+// build 后以 CSR 方式连续存放，同一槽内保持登记顺序。
+// 取出某个槽的全部条目是 O(1) 加条目数，与条目总数无关
+class TimingWheel {
+  public:
+    // 一个槽内条目的只读视图
+    class Bucket {
+      public:
+        Bucket(const std::size_t *first, const std::size_t *last)
+            : first(first), last(last) {}
+        const std::size_t *begin() const { return first; }
+        const std::size_t *end() const { return last; }
+        std::size_t size() const { return std::size_t(last - first); }
+        bool empty() const { return first == last; }
+
+      private:
+        const std::size_t *first;
+        const std::size_t *last;
+    };
+
+    explicit TimingWheel(int slots);
+
+    void clear();
+    // 槽号超出 [0, slots) 的条目永远不会触发，直接忽略
+    void add(int slot, std::size_t item);
+    void build();
+
+    int getSlots() const { return slots; }
+    std::size_t size() const { return items.size(); }
+    Bucket at(int slot) const; // 需要先 build
+
+  private:
+    int slots;
+    std::vector<std::pair<int, std::size_t>> pending; // 尚未 build 的条目
+    std::vector<std::size_t> offsets; // 第 i 个槽的条目为 items[offsets[i], offsets[i+1])
+    std::vector<std::size_t> items;
+};
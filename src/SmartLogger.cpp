@@ -1,6 +1,9 @@
 #include "SmartLogger.h"
+#include "binaryLog.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <ctime>
 
 // 日志级别字符串
 std::string LogLevelToString(LogLevel level) {
@@ -12,10 +15,63 @@ std::string LogLevelToString(LogLevel level) {
     }
 }
 
+void appendWallTime(std::string& out, std::chrono::system_clock::time_point time) {
+    // 每个格式化线程各自缓存最近一秒的 "YYYY-MM-DD HH:MM:SS"
+    thread_local std::time_t cachedSecond = -1;
+    thread_local char cachedText[32] = {0};
+    thread_local std::size_t cachedLength = 0;
+
+    auto sinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+        time.time_since_epoch()).count();
+    std::time_t second = std::time_t(sinceEpoch / 1000);
+    int millis = int(sinceEpoch % 1000);
+    if (millis < 0) {
+        millis += 1000;
+        --second;
+    }
+    if (second != cachedSecond) {
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &second);
+#else
+        localtime_r(&second, &tm);
+#endif
+        cachedLength = std::strftime(cachedText, sizeof(cachedText),
+                                     "%Y-%m-%d %H:%M:%S", &tm);
+        cachedSecond = second;
+    }
+    char suffix[4] = {'.', char('0' + millis / 100),
+                      char('0' + millis / 10 % 10), char('0' + millis % 10)};
+    out.append(cachedText, cachedLength);
+    out.append(suffix, sizeof(suffix));
+}
+
+const std::string& currentThreadIdText() {
+    thread_local const std::string text = []() {
+        std::ostringstream oss;
+        oss << std::this_thread::get_id();
+        return oss.str();
+    }();
+    return text;
+}
+
+void LogOutputter::writeBatch(const std::vector<std::string>& messages) {
+    for (auto& message : messages) {
+        write(message);
+    }
+}
+
 void ConsoleOutputter::write(const std::string& message) {
     std::cout << message << std::endl;
 }
 
+void ConsoleOutputter::writeBatch(const std::vector<std::string>& messages) {
+    for (auto& message : messages) {
+        std::cout << message << '\n';
+    }
+    std::cout.flush();
+}
+
 FileOutputter::FileOutputter(const std::string& filename) {
     fileStream.open(filename, std::ios::app);
 }
@@ -29,20 +85,38 @@ void FileOutputter::write(const std::string& message) {
         fileStream.flush();
     }
 }
+void FileOutputter::writeBatch(const std::vector<std::string>& messages) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (fileStream.is_open()) {
+        for (auto& message : messages) {
+            fileStream << message << '\n';
+        }
+        fileStream.flush();
+    }
+}
 
-SmartLogger* SmartLogger::instance = nullptr;
+std::atomic<SmartLogger*> SmartLogger::instance(nullptr);
 std::mutex SmartLogger::instanceMutex;
 
-SmartLogger::SmartLogger() : minLevel(LogLevel::DEBUG) {
+SmartLogger::SmartLogger()
+    : minLevel(LogLevel::DEBUG), textOutputterCount(1), async(false),
+      overflowPolicy(OverflowPolicy::Block), sampleRate(1), stopping(false),
+      written(0), dropped(0), overflowed(0), writerSleeping(false) {
     outputters.push_back(std::make_unique<ConsoleOutputter>());
 }
 
+// 创建之后每次调用只有一次 acquire 读取，不再获取 instanceMutex
 SmartLogger* SmartLogger::getInstance() {
-    std::lock_guard<std::mutex> lock(instanceMutex);
-    if (instance == nullptr) {
-        instance = new SmartLogger();
+    SmartLogger* logger = instance.load(std::memory_order_acquire);
+    if (logger == nullptr) {
+        std::lock_guard<std::mutex> lock(instanceMutex);
+        logger = instance.load(std::memory_order_relaxed);
+        if (logger == nullptr) {
+            logger = new SmartLogger();
+            instance.store(logger, std::memory_order_release);
+        }
     }
-    return instance;
+    return logger;
 }
 
 void SmartLogger::setMinLevel(LogLevel level) {
@@ -52,38 +126,244 @@ void SmartLogger::setMinLevel(LogLevel level) {
 void SmartLogger::addOutputter(std::unique_ptr<LogOutputter> outputter) {
     std::lock_guard<std::mutex> lock(loggerMutex);
     outputters.push_back(std::move(outputter));
+    textOutputterCount = int(outputters.size());
+}
+
+void SmartLogger::removeOutputters() {
+    std::lock_guard<std::mutex> lock(loggerMutex);
+    outputters.clear();
+    textOutputterCount = 0;
+}
+
+void SmartLogger::setBinaryLog(std::shared_ptr<BinaryLogWriter> writer) {
+    std::atomic_store(&binaryLog, std::move(writer));
+}
+
+void SmartLogger::setTimeSource(std::function<std::string()> source) {
+    std::shared_ptr<const TimeSource> shared;
+    if (source) {
+        shared = std::make_shared<const TimeSource>(std::move(source));
+    }
+    std::atomic_store(&timeSource, shared);
+}
+
+// 切换模式时不应有其他线程正在调用 log()
+void SmartLogger::enableAsync(std::size_t capacity, OverflowPolicy policy,
+                              int sampleRate) {
+    if (async) {
+        return;
+    }
+    ring = std::make_unique<MpscRing<LogRecord>>(capacity);
+    overflowPolicy = policy;
+    this->sampleRate = std::max(1, sampleRate);
+    stopping = false;
+    written = 0;
+    overflowed = 0;
+    writerThread = std::thread(&SmartLogger::writerLoop, this);
+    async = true;
+}
+
+void SmartLogger::disableAsync() {
+    if (!async) {
+        return;
+    }
+    // 后台线程写完队列中剩余的记录后才退出
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        writerWakeup.notify_one();
+    }
+    writerThread.join();
+    async = false;
+    ring.reset();
+}
+
+void SmartLogger::flush() {
+    if (async) {
+        waitWritten(ring->claimed());
+    }
+    std::lock_guard<std::mutex> lock(loggerMutex);
+    for (auto& outputter : outputters) {
+        outputter->flush();
+    }
+}
+
+LogRecord SmartLogger::makeRecord(LogLevel level, int deviceId) {
+    LogRecord record;
+    record.level = level;
+    record.deviceId = deviceId;
+    std::shared_ptr<const TimeSource> source = std::atomic_load(&timeSource);
+    if (source) {
+        record.timeText = (*source)();
+    } else {
+        record.time = std::chrono::system_clock::now();
+    }
+    record.threadId = currentThreadIdText();
+    return record;
 }
 
 void SmartLogger::log(LogLevel level, int deviceId, const std::string& message) {
     if (level < minLevel) return;
+    LogRecord record = makeRecord(level, deviceId);
+    std::shared_ptr<BinaryLogWriter> binary = std::atomic_load(&binaryLog);
+    if (binary) {
+        LogArg arg(message);
+        binary->write(level, deviceId, LogFormat::Text, record.time,
+                      record.timeText, &arg, 1);
+    }
+    if (textOutputterCount == 0) return;
+    record.message = message;
+    dispatch(record);
+}
+
+void SmartLogger::logArgs(LogLevel level, int deviceId, LogFormat format,
+                          const LogArg* args, std::size_t count) {
+    if (level < minLevel) return;
+    LogRecord record = makeRecord(level, deviceId);
+    std::shared_ptr<BinaryLogWriter> binary = std::atomic_load(&binaryLog);
+    if (binary) {
+        binary->write(level, deviceId, format, record.time, record.timeText,
+                      args, count);
+    }
+    if (textOutputterCount == 0) return;
+    const char* pattern = logFormatPattern(format);
+    record.message = formatLogPattern(pattern ? pattern : "", args, count);
+    dispatch(record);
+}
+
+void SmartLogger::dispatch(LogRecord& record) {
+    if (!async) {
+        writeSync(record);
+        return;
+    }
+    bool alert = record.level == LogLevel::ALERT;
+    std::size_t count = push(record, alert);
+    if (alert) {
+        waitWritten(count);
+    }
+}
+
+void SmartLogger::log(LogLevel level, const std::string& message) {
+    log(level, -1, message);
+}
+
+void SmartLogger::writeSync(const LogRecord& record) {
     std::lock_guard<std::mutex> lock(loggerMutex);
-    std::ostringstream oss;
-    oss << "[" << getCurrentTime() << "] "
-        << "[" << LogLevelToString(level) << "] "
-        << "[Device:" << deviceId << "] "
-        << "[Thread:" << getThreadId() << "] "
-        << message;
-    std::string logMessage = oss.str();
+    std::string logMessage = format(record);
     for (auto& outputter : outputters) {
         outputter->write(logMessage);
+        // 缓冲输出时 ALERT 同样要在 log() 返回前落盘
+        if (record.level == LogLevel::ALERT) {
+            outputter->flush();
+        }
     }
 }
 
-void SmartLogger::log(LogLevel level, const std::string& message) {
-    log(level, -1, message);
+std::size_t SmartLogger::push(LogRecord& record, bool mustKeep) {
+    std::size_t position = 0;
+    if (!ring->tryPush(record, &position)) {
+        if (!mustKeep) {
+            if (overflowPolicy == OverflowPolicy::Drop ||
+                (overflowPolicy == OverflowPolicy::Sample &&
+                 ++overflowed % sampleRate != 0)) {
+                ++dropped;
+                return 0;
+            }
+        }
+        while (!ring->tryPush(record, &position)) {
+            wakeWriter();
+            std::this_thread::yield();
+        }
+    }
+    // 与 writerLoop 中的 fence 配对：后台线程要么看到新记录，要么已标记为
+    // 睡眠并在这里被唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerSleeping) {
+        wakeWriter();
+    }
+    return position + 1;
 }
 
-std::string SmartLogger::getCurrentTime() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto tm = *std::localtime(&time_t);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+void SmartLogger::wakeWriter() {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    writerWakeup.notify_one();
 }
 
-std::string SmartLogger::getThreadId() {
-    std::ostringstream oss;
-    oss << std::this_thread::get_id();
-    return oss.str();
-} 
\ No newline at end of file
+void SmartLogger::waitWritten(std::size_t count) {
+    std::unique_lock<std::mutex> lock(writerMutex);
+    writerWakeup.notify_one();
+    writtenChanged.wait(lock, [this, count]() { return written >= count; });
+}
+
+void SmartLogger::writerLoop() {
+    const std::size_t batchSize = 256;
+    std::vector<LogRecord> records;
+    std::vector<std::string> lines;
+    LogRecord record;
+    while (true) {
+        records.clear();
+        while (records.size() < batchSize && ring->tryPop(record)) {
+            records.push_back(std::move(record));
+        }
+        if (records.empty()) {
+            if (stopping) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(writerMutex);
+            writerSleeping = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            writerWakeup.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+                return stopping || ring->readable();
+            });
+            writerSleeping = false;
+            continue;
+        }
+
+        lines.clear();
+        bool alert = false;
+        for (auto& r : records) {
+            lines.push_back(format(r));
+            alert = alert || r.level == LogLevel::ALERT;
+        }
+        {
+            std::lock_guard<std::mutex> lock(loggerMutex);
+            for (auto& outputter : outputters) {
+                outputter->writeBatch(lines);
+                // 批次中有 ALERT 时，先落盘再通知等待中的 log()
+                if (alert) {
+                    outputter->flush();
+                }
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            written += records.size();
+        }
+        writtenChanged.notify_all();
+    }
+}
+
+std::string SmartLogger::format(const LogRecord& record) {
+    std::string line;
+    line.reserve(80 + record.message.size());
+    line += '[';
+    if (record.timeText.empty()) {
+        appendWallTime(line, record.time);
+    } else {
+        line += record.timeText;
+    }
+    line += "] [";
+    line += LogLevelToString(record.level);
+    line += "] [Device:";
+    line += std::to_string(record.deviceId);
+    line += "] [Thread:";
+    // 使用时间源时线程号固定为 0
+    if (record.timeText.empty()) {
+        line += record.threadId;
+    } else {
+        line += '0';
+    }
+    line += "] ";
+    line += record.message;
+    return line;
+}
\ No newline at end of file
@@ -1,21 +1,88 @@
 #include "airConditioner.h"
+#include "SmartLogger.h"
 #include "common.h"
 #include <iostream>
 
 double AirConditioner::getTargetTemperature() const {
-    return targetTemperature;
+    return field(TARGET_TEMPERATURE_FIELD, targetTemperature)
+        .load(std::memory_order_relaxed);
 }
 
-double AirConditioner::getSpeed() const { return speed; }
+double AirConditioner::getSpeed() const {
+    return field(SPEED_FIELD, speed).load(std::memory_order_relaxed);
+}
 
-std::string AirConditioner::getMode() const { return mode; }
-void AirConditioner::setMode(const std::string &m) { mode = m; }
+std::string_view toString(AirConditionerMode mode) {
+    switch (mode) {
+    case AirConditionerMode::Cool:
+        return "cool";
+    case AirConditionerMode::Heat:
+        return "heat";
+    default:
+        return "off";
+    }
+}
+
+bool parseAirConditionerMode(std::string_view text, AirConditionerMode &mode) {
+    if (text == "off") {
+        mode = AirConditionerMode::Off;
+    } else if (text == "cool") {
+        mode = AirConditionerMode::Cool;
+    } else if (text == "heat") {
+        mode = AirConditionerMode::Heat;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+AirConditionerMode AirConditioner::getModeValue() const {
+    return mode.load(std::memory_order_relaxed);
+}
+
+void AirConditioner::setMode(AirConditionerMode m) {
+    mode.store(m, std::memory_order_relaxed);
+}
+
+std::string AirConditioner::getMode() const {
+    return std::string(toString(getModeValue()));
+}
+
+void AirConditioner::setMode(const std::string &m) {
+    // 未知字符串按关闭处理，与原先行为一致
+    AirConditionerMode value = AirConditionerMode::Off;
+    parseAirConditionerMode(m, value);
+    setMode(value);
+}
 
 void AirConditioner::setTargetTemperature(double temperature) {
-    targetTemperature = temperature;
+    field(TARGET_TEMPERATURE_FIELD, targetTemperature)
+        .store(temperature, std::memory_order_relaxed);
 }
 
-void AirConditioner::setSpeed(double speed) { this->speed = speed; }
+void AirConditioner::setSpeed(double speed) {
+    field(SPEED_FIELD, this->speed).store(speed, std::memory_order_relaxed);
+}
+
+void AirConditioner::saveFieldsToColumns() {
+    DeviceColumnBlock *block = column.block;
+    block->fields[TARGET_TEMPERATURE_FIELD][column.index].store(
+        targetTemperature.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    block->fields[SPEED_FIELD][column.index].store(
+        speed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void AirConditioner::loadFieldsFromColumns() {
+    DeviceColumnBlock *block = column.block;
+    targetTemperature.store(
+        block->fields[TARGET_TEMPERATURE_FIELD][column.index].load(
+            std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    speed.store(block->fields[SPEED_FIELD][column.index].load(
+                    std::memory_order_relaxed),
+                std::memory_order_relaxed);
+}
 
 DeviceType AirConditioner::getDeviceType() const {
     return DeviceType::AirConditioner;
@@ -26,17 +93,17 @@ void AirConditioner::update() { return; }
 json AirConditioner::toJson() const {
     return {{"id", id},
             {"name", name},
-            {"priorityLevel", priorityLevel},
-            {"powerConsumption", powerConsumption},
-            {"updateFrequency", updateFrequency},
-            {"targetTemperature", targetTemperature},
-            {"speed", speed},
-            {"mode", mode}};
+            {"priorityLevel", getPriorityLevel()},
+            {"powerConsumption", getPowerConsumption()},
+            {"updateFrequency", getUpdateFrequency()},
+            {"targetTemperature", getTargetTemperature()},
+            {"speed", getSpeed()},
+            {"mode", getMode()}};
 }
 
 Device *AirConditionerFactory::createDevice() {
     AirConditioner *air_conditioner =
-        new AirConditioner("Air Conditioner", 0, 100, 25, 1.0);
+        pool.create("Air Conditioner", 0, 100, 25, 1.0);
     return air_conditioner;
 }
 
@@ -73,6 +140,16 @@ Device *AirConditionerFactory::createDevice(const json &param) {
             param, "speed must be between " + std::to_string(0) + " and " +
                        std::to_string(MAX_AIR_CONDITIONER_SPEED));
     }
+    // mode 为可选字段（toJson 会输出），缺省为 off。无法识别的值同样按 off
+    // 处理，旧清单仍可导入，并记录一条告警日志
+    AirConditionerMode mode = AirConditionerMode::Off;
+    bool unknownMode = false;
+    if (param.contains("mode")) {
+        const json &value = param["mode"];
+        unknownMode = !value.is_string() ||
+                      !parseAirConditionerMode(
+                          value.get_ref<const std::string &>(), mode);
+    }
 
     std::string name = param["name"];
     int priorityLevel = param["priorityLevel"];
@@ -83,10 +160,39 @@ Device *AirConditionerFactory::createDevice(const json &param) {
     // 获取updateFrequency，如果不存在则使用默认值
     int updateFrequency = param.value("updateFrequency", 1000);
 
-    return new AirConditioner(name, priorityLevel, powerConsumption,
-                              targetTemperature, speed, updateFrequency);
+    AirConditioner *air_conditioner =
+        pool.create(name, priorityLevel, powerConsumption, targetTemperature,
+                    speed, updateFrequency);
+    air_conditioner->setMode(mode);
+    if (unknownMode) {
+        LOG_ALERT(air_conditioner->getId(),
+                  "空调 " + name + " 的模式 " + param["mode"].dump() +
+                      " 无法识别，按 off 处理");
+    }
+    return air_conditioner;
+}
+
+AirConditioner *AirConditionerFactory::create(
+    const std::string &name, int priorityLevel, double powerConsumption,
+    double targetTemperature, double speed, AirConditionerMode mode,
+    int updateFrequency) {
+    AirConditioner *air_conditioner =
+        pool.create(name, priorityLevel, powerConsumption, targetTemperature,
+                    speed, updateFrequency);
+    air_conditioner->setMode(mode);
+    return air_conditioner;
+}
+
+void AirConditionerFactory::destroyDevice(Device *device) {
+    if (pool.owns(device)) {
+        pool.destroy(static_cast<AirConditioner *>(device));
+    } else {
+        delete device;
+    }
 }
 
+void AirConditionerFactory::reserve(int count) { pool.reserve(count); }
+
 void AirConditionerContainer::changeDevice(int id) {
     AirConditioner *ac = dynamic_cast<AirConditioner *>(getDevice(id));
     if (ac) {
@@ -0,0 +1,218 @@
+#include "binaryLog.h"
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+
+static const char MAGIC[5] = {'H', 'S', 'L', 'O', 'G'};
+static const std::uint16_t VERSION = 1;
+
+enum EntryKind : std::uint8_t {
+    FormatDefinition = 1,
+    ThreadDefinition = 2,
+    Record = 3,
+};
+
+template <typename T> static void put(std::ofstream &stream, T value) {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void putText(std::ofstream &stream, const std::string &text) {
+    put(stream, std::uint32_t(text.size()));
+    stream.write(text.data(), std::streamsize(text.size()));
+}
+
+static std::atomic<std::uint64_t> nextWriterId(1);
+
+BinaryLogWriter::BinaryLogWriter(const std::string &filename)
+    : buffer(1 << 16), definedFormats(std::size_t(LogFormat::Count), false),
+      writerId(nextWriterId++), nextThread(0) {
+    stream.rdbuf()->pubsetbuf(buffer.data(), std::streamsize(buffer.size()));
+    stream.open(filename, std::ios::binary | std::ios::trunc);
+    if (stream.is_open()) {
+        stream.write(MAGIC, sizeof(MAGIC));
+        put(stream, VERSION);
+    }
+}
+
+BinaryLogWriter::~BinaryLogWriter() {
+    flush();
+    stream.close();
+}
+
+void BinaryLogWriter::flush() {
+    std::lock_guard<std::mutex> lock(streamMutex);
+    stream.flush();
+}
+
+std::uint32_t BinaryLogWriter::threadIndex() {
+    // 每个线程记住自己在最近一个写入器中的序号，切换写入器后重新登记
+    thread_local std::uint64_t cachedWriter = 0;
+    thread_local std::uint32_t cachedIndex = 0;
+    if (cachedWriter != writerId) {
+        cachedWriter = writerId;
+        cachedIndex = nextThread++;
+        put(stream, std::uint8_t(ThreadDefinition));
+        put(stream, cachedIndex);
+        putText(stream, currentThreadIdText());
+    }
+    return cachedIndex;
+}
+
+void BinaryLogWriter::write(LogLevel level, int deviceId, LogFormat format,
+                            std::chrono::system_clock::time_point time,
+                            const std::string &timeText, const LogArg *args,
+                            std::size_t count) {
+    std::lock_guard<std::mutex> lock(streamMutex);
+    if (!stream.is_open()) {
+        return;
+    }
+    std::size_t id = std::size_t(format);
+    if (id < definedFormats.size() && !definedFormats[id]) {
+        definedFormats[id] = true;
+        put(stream, std::uint8_t(FormatDefinition));
+        put(stream, std::uint16_t(format));
+        putText(stream, logFormatPattern(format));
+    }
+    std::uint32_t thread = threadIndex();
+
+    put(stream, std::uint8_t(Record));
+    put(stream, std::uint8_t(level));
+    put(stream, std::uint16_t(format));
+    put(stream, std::int32_t(deviceId));
+    put(stream, thread);
+    if (timeText.empty()) {
+        put(stream, std::uint8_t(0));
+        put(stream, std::int64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     time.time_since_epoch())
+                                     .count()));
+    } else {
+        put(stream, std::uint8_t(1));
+        putText(stream, timeText);
+    }
+    put(stream, std::uint8_t(count));
+    for (std::size_t i = 0; i < count; ++i) {
+        put(stream, std::uint8_t(args[i].type));
+        switch (args[i].type) {
+        case LogArg::Integer:
+            put(stream, args[i].integer);
+            break;
+        case LogArg::Real:
+            put(stream, args[i].real);
+            break;
+        case LogArg::Text:
+            putText(stream, args[i].text);
+            break;
+        }
+    }
+    if (level == LogLevel::ALERT) {
+        stream.flush();
+    }
+}
+
+// 解码时按字节读取，读到文件末尾返回 false
+template <typename T> static bool get(std::istream &in, T &value) {
+    return bool(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+static bool getText(std::istream &in, std::string &text) {
+    std::uint32_t size = 0;
+    if (!get(in, size)) {
+        return false;
+    }
+    text.resize(size);
+    return size == 0 || bool(in.read(&text[0], size));
+}
+
+bool decodeBinaryLog(std::istream &in, std::ostream &out, std::string *error) {
+    auto fail = [error](const std::string &reason) {
+        if (error) {
+            *error = reason;
+        }
+        return false;
+    };
+
+    char magic[sizeof(MAGIC)];
+    std::uint16_t version = 0;
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !get(in, version)) {
+        return fail("not a HomeSphere binary log");
+    }
+    if (version != VERSION) {
+        return fail("unsupported version " + std::to_string(version));
+    }
+
+    std::unordered_map<std::uint16_t, std::string> patterns;
+    std::unordered_map<std::uint32_t, std::string> threads;
+    std::vector<LogArg> args;
+    std::uint8_t kind = 0;
+    while (get(in, kind)) {
+        if (kind == FormatDefinition) {
+            std::uint16_t id = 0;
+            if (!get(in, id) || !getText(in, patterns[id])) {
+                return fail("truncated format definition");
+            }
+        } else if (kind == ThreadDefinition) {
+            std::uint32_t index = 0;
+            if (!get(in, index) || !getText(in, threads[index])) {
+                return fail("truncated thread definition");
+            }
+        } else if (kind == Record) {
+            std::uint8_t level = 0, timeKind = 0, count = 0;
+            std::uint16_t format = 0;
+            std::int32_t deviceId = 0;
+            std::uint32_t thread = 0;
+            std::string time;
+            bool ok = get(in, level) && get(in, format) && get(in, deviceId) &&
+                      get(in, thread) && get(in, timeKind);
+            if (ok && timeKind == 0) {
+                std::int64_t micros = 0;
+                ok = get(in, micros);
+                appendWallTime(time, std::chrono::system_clock::time_point(
+                                         std::chrono::microseconds(micros)));
+            } else if (ok) {
+                ok = getText(in, time);
+            }
+            ok = ok && get(in, count);
+            args.clear();
+            for (int i = 0; ok && i < count; ++i) {
+                std::uint8_t type = 0;
+                ok = get(in, type);
+                if (!ok) {
+                    break;
+                }
+                if (type == LogArg::Integer) {
+                    std::int64_t value = 0;
+                    ok = get(in, value);
+                    args.emplace_back(static_cast<long long>(value));
+                } else if (type == LogArg::Real) {
+                    double value = 0;
+                    ok = get(in, value);
+                    args.emplace_back(value);
+                } else {
+                    std::string value;
+                    ok = getText(in, value);
+                    args.emplace_back(std::move(value));
+                }
+            }
+            if (!ok) {
+                return fail("truncated record");
+            }
+            auto pattern = patterns.find(format);
+            if (pattern == patterns.end()) {
+                return fail("record uses undefined format " +
+                            std::to_string(format));
+            }
+            // 使用时间源时线程号固定为 0，与文本日志一致
+            std::string threadText = timeKind == 0 ? threads[thread] : "0";
+            out << "[" << time << "] "
+                << "[" << LogLevelToString(LogLevel(level)) << "] "
+                << "[Device:" << deviceId << "] "
+                << "[Thread:" << threadText << "] "
+                << formatLogPattern(pattern->second, args.data(), args.size())
+                << "\n";
+        } else {
+            return fail("unknown entry kind " + std::to_string(kind));
+        }
+    }
+    return true;
+}
@@ -3,37 +3,135 @@
 #include "exception.h"
 #include <string>
 
-int Device::nextId = 0;
+std::atomic<int> Device::nextId(0);
+thread_local Device::IdScope *Device::idScope = nullptr;
+
+Device::~Device() {
+    if (column.block) {
+        column.block->owner->release(column);
+    }
+}
+
+void Device::bindColumns(DeviceColumnStore *store) {
+    if (column.block) {
+        unbindColumns();
+    }
+    column = store->acquire();
+    DeviceColumnBlock *block = column.block;
+    int i = column.index;
+    block->id[i].store(id, std::memory_order_relaxed);
+    block->state[i].store(state.load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+    block->priorityLevel[i].store(
+        priorityLevel.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    block->powerConsumption[i].store(
+        powerConsumption.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    saveFieldsToColumns();
+}
+
+void Device::unbindColumns() {
+    if (!column.block) {
+        return;
+    }
+    DeviceColumnBlock *block = column.block;
+    int i = column.index;
+    state.store(block->state[i].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    priorityLevel.store(block->priorityLevel[i].load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    powerConsumption.store(
+        block->powerConsumption[i].load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    loadFieldsFromColumns();
+    block->owner->release(column);
+    column = DeviceColumnRef();
+}
+
+bool Device::isColumnBound() const { return column.block != nullptr; }
+
+std::atomic<double> &Device::field(int index, std::atomic<double> &member) {
+    return column.block ? column.block->fields[index][column.index] : member;
+}
+
+const std::atomic<double> &
+Device::field(int index, const std::atomic<double> &member) const {
+    return column.block ? column.block->fields[index][column.index] : member;
+}
+
+int Device::reserveIds(int count) { return nextId.fetch_add(count); }
+
+bool Device::releaseIds(int first, int end) {
+    return first < end && nextId.compare_exchange_strong(end, first);
+}
+
+int Device::allocateId() { return idScope ? idScope->next++ : nextId++; }
+
+Device::IdScope::IdScope(int first) : next(first), previous(idScope) {
+    idScope = this;
+}
+
+Device::IdScope::~IdScope() { idScope = previous; }
+
 
 int Device::getId() const { return id; }
 
 // 删除 getName 的实现，改为纯虚函数由子类实现
 std::string Device::getName() { return name; }
 
-int Device::getPriorityLevel() const { return priorityLevel; }
+int Device::getPriorityLevel() const {
+    const std::atomic<int> &value =
+        column.block ? column.block->priorityLevel[column.index]
+                     : priorityLevel;
+    return value.load(std::memory_order_relaxed);
+}
 
-double Device::getPowerConsumption() const { return powerConsumption; }
+double Device::getPowerConsumption() const {
+    const std::atomic<double> &value =
+        column.block ? column.block->powerConsumption[column.index]
+                     : powerConsumption;
+    return value.load(std::memory_order_relaxed);
+}
 
-bool Device::getState() const { return state; }
+bool Device::getState() const {
+    const std::atomic<bool> &value =
+        column.block ? column.block->state[column.index] : state;
+    return value.load(std::memory_order_relaxed);
+}
 
-int Device::getUpdateFrequency() const { return updateFrequency; }
+int Device::getUpdateFrequency() const {
+    return updateFrequency.load(std::memory_order_relaxed);
+}
 
 void Device::setName(const std::string &name) { this->name = name; }
 
 void Device::setPriorityLevel(int priorityLevel) {
-    this->priorityLevel = priorityLevel;
+    std::atomic<int> &value =
+        column.block ? column.block->priorityLevel[column.index]
+                     : this->priorityLevel;
+    value.store(priorityLevel, std::memory_order_relaxed);
 }
 
 void Device::setPowerConsumption(double powerConsumption) {
-    this->powerConsumption = powerConsumption;
+    std::atomic<double> &value =
+        column.block ? column.block->powerConsumption[column.index]
+                     : this->powerConsumption;
+    value.store(powerConsumption, std::memory_order_relaxed);
 }
 
-void Device::setState(bool state) { this->state = state; }
+void Device::setState(bool state) {
+    std::atomic<bool> &value =
+        column.block ? column.block->state[column.index] : this->state;
+    value.store(state, std::memory_order_relaxed);
+}
 
-void Device::setUpdateFrequency(int frequency) { 
-    this->updateFrequency = frequency; 
+void Device::setUpdateFrequency(int frequency) {
+    updateFrequency.store(frequency, std::memory_order_relaxed);
 }
 
+void DeviceFactory::destroyDevice(Device *device) { delete device; }
+
 bool DeviceFactory::check(const json &param) const {
     if (!param.contains("name")) {
         throw InvalidParameterException(param, "Missing required field: name");
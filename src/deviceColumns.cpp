@@ -0,0 +1,63 @@
+#include "deviceColumns.h"
+#include <stdexcept>
+
+DeviceColumnStore::~DeviceColumnStore() {
+    int count = blockCount.load();
+    for (int i = 0; i < count; ++i) {
+        delete blocks[i].load();
+    }
+    blockCount = 0;
+}
+
+DeviceColumnRef DeviceColumnStore::acquire() {
+    std::lock_guard<std::mutex> lock(slotMutex);
+    DeviceColumnRef ref;
+    if (!freeSlots.empty()) {
+        ref = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        int count = blockCount.load();
+        if (tailUsed.load() == DEVICE_COLUMN_BLOCK_SIZE) {
+            if (count == DEVICE_COLUMN_MAX_BLOCKS) {
+                throw std::length_error("DeviceColumnStore is full");
+            }
+            DeviceColumnBlock *block = new DeviceColumnBlock();
+            block->owner = this;
+            blocks[count].store(block);
+            // 先让新块的已用数归零，再让读者看到它
+            tailUsed.store(0);
+            blockCount.store(++count);
+        }
+        ref.block = blocks[count - 1].load();
+        ref.index = tailUsed.load();
+        tailUsed.store(ref.index + 1);
+    }
+    ref.block->live[ref.index] = true;
+    ++liveCount;
+    return ref;
+}
+
+void DeviceColumnStore::release(DeviceColumnRef ref) {
+    if (ref.block == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(slotMutex);
+    ref.block->live[ref.index] = false;
+    freeSlots.push_back(ref);
+    --liveCount;
+}
+
+int DeviceColumnStore::getLiveCount() const {
+    std::lock_guard<std::mutex> lock(slotMutex);
+    return liveCount;
+}
+
+int DeviceColumnStore::getBlockCount() const { return blockCount.load(); }
+
+DeviceColumnBlock *DeviceColumnStore::getBlock(int i) const {
+    return blocks[i].load();
+}
+
+int DeviceColumnStore::getBlockUsed(int i) const {
+    return i + 1 == getBlockCount() ? tailUsed.load() : DEVICE_COLUMN_BLOCK_SIZE;
+}
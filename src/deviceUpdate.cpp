@@ -0,0 +1,51 @@
+#include "deviceUpdate.h"
+#include "seqLock.h"
+
+void updateAll(LightContainer &lights, DeviceUpdateContext &ctx) {
+    DeviceColumnStore *columns = lights.getColumns();
+    if (!columns) {
+        updateAll(static_cast<DeviceContainer<Light> &>(lights), ctx);
+        return;
+    }
+    bool on = DeviceUpdater<Light>::isOn(ctx);
+    double lightness = on ? LIGHT_EVENING_LIGHTNESS : 0;
+    columns->forEachBlock([&](DeviceColumnBlock &block, int used) {
+        for (int i = 0; i < used; ++i) {
+            block.state[i].store(on, std::memory_order_relaxed);
+        }
+        std::atomic<double> *values = block.fields[Light::LIGHTNESS_FIELD];
+        for (int i = 0; i < used; ++i) {
+            values[i].store(lightness, std::memory_order_relaxed);
+        }
+    });
+}
+
+void updateAll(SensorContainer &sensors, DeviceUpdateContext &ctx) {
+    DeviceColumnStore *columns = sensors.getColumns();
+    if (!columns) {
+        updateAll(static_cast<DeviceContainer<Sensor> &>(sensors), ctx);
+        return;
+    }
+    if (ctx.emergency) {
+        return;
+    }
+    const SensorReadings &env = ctx.environment;
+    // 调用者是传感器读数的唯一写者，逐个槽位按序列锁写入三项读数
+    columns->forEachBlock([&](DeviceColumnBlock &block, int used) {
+        std::atomic<double> *temps = block.fields[Sensor::TEMPERATURE_FIELD];
+        std::atomic<double> *hums = block.fields[Sensor::HUMIDITY_FIELD];
+        std::atomic<double> *co2s = block.fields[Sensor::CO2_FIELD];
+        for (int i = 0; i < used; ++i) {
+            seqWriteBegin(block.sequence[i]);
+            temps[i].store(env.temperature, std::memory_order_relaxed);
+            hums[i].store(env.humidity, std::memory_order_relaxed);
+            co2s[i].store(env.CO2_Concentration, std::memory_order_relaxed);
+            seqWriteEnd(block.sequence[i]);
+        }
+    });
+}
+
+void updateAll(AirConditionerContainer &acs, DeviceUpdateContext &ctx) {
+    // 空调的模式不在列式存储中，始终逐个设备更新
+    updateAll(static_cast<DeviceContainer<AirConditioner> &>(acs), ctx);
+}
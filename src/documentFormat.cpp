@@ -0,0 +1,110 @@
+#include "documentFormat.h"
+#include <vector>
+
+namespace {
+
+const DocumentFormat FORMATS[] = {DocumentFormat::Json, DocumentFormat::Cbor,
+                                  DocumentFormat::MessagePack,
+                                  DocumentFormat::Bson, DocumentFormat::Ubjson};
+
+bool endsWith(const std::string &text, const std::string &suffix) {
+    return text.size() > suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+const char *documentExtension(DocumentFormat format) {
+    switch (format) {
+    case DocumentFormat::Json:
+        return ".json";
+    case DocumentFormat::Cbor:
+        return ".cbor";
+    case DocumentFormat::MessagePack:
+        return ".msgpack";
+    case DocumentFormat::Bson:
+        return ".bson";
+    case DocumentFormat::Ubjson:
+        return ".ubj";
+    }
+    return ".json";
+}
+
+bool documentFormatFromName(const std::string &filename, DocumentFormat &format) {
+    for (DocumentFormat candidate : FORMATS) {
+        if (endsWith(filename, documentExtension(candidate))) {
+            format = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string resolveDocumentPath(const std::string &directory,
+                                const std::string &filename,
+                                DocumentFormat &format) {
+    if (documentFormatFromName(filename, format)) {
+        return directory + filename;
+    }
+    format = DocumentFormat::Json;
+    return directory + filename + documentExtension(format);
+}
+
+json::input_format_t saxInputFormat(DocumentFormat format) {
+    switch (format) {
+    case DocumentFormat::Json:
+        return json::input_format_t::json;
+    case DocumentFormat::Cbor:
+        return json::input_format_t::cbor;
+    case DocumentFormat::MessagePack:
+        return json::input_format_t::msgpack;
+    case DocumentFormat::Bson:
+        return json::input_format_t::bson;
+    case DocumentFormat::Ubjson:
+        return json::input_format_t::ubjson;
+    }
+    return json::input_format_t::json;
+}
+
+json readDocument(std::istream &in, DocumentFormat format) {
+    switch (format) {
+    case DocumentFormat::Json:
+        return json::parse(in);
+    case DocumentFormat::Cbor:
+        return json::from_cbor(in);
+    case DocumentFormat::MessagePack:
+        return json::from_msgpack(in);
+    case DocumentFormat::Bson:
+        return json::from_bson(in);
+    case DocumentFormat::Ubjson:
+        return json::from_ubjson(in);
+    }
+    return json::parse(in);
+}
+
+void writeDocument(std::ostream &out, const json &document,
+                   DocumentFormat format) {
+    if (format == DocumentFormat::Json) {
+        out << document.dump(4);
+        return;
+    }
+    std::vector<std::uint8_t> bytes;
+    switch (format) {
+    case DocumentFormat::Cbor:
+        json::to_cbor(document, bytes);
+        break;
+    case DocumentFormat::MessagePack:
+        json::to_msgpack(document, bytes);
+        break;
+    case DocumentFormat::Bson:
+        json::to_bson(document, bytes);
+        break;
+    case DocumentFormat::Ubjson:
+        json::to_ubjson(document, bytes);
+        break;
+    default:
+        break;
+    }
+    out.write(reinterpret_cast<const char *>(bytes.data()),
+              std::streamsize(bytes.size()));
+}
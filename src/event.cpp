@@ -0,0 +1,97 @@
+#include "event.h"
+#include "exception.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// 整数字段同样接受 480.0 这类整值的浮点数，部分工具导出时不区分整数；
+// 超出 int 范围的值一律拒绝，不做截断
+static int optionalInt(const json &param, const char *key, int fallback) {
+    if (!param.contains(key)) {
+        return fallback;
+    }
+    const json &value = param[key];
+    if (value.is_number_unsigned()) {
+        if (value.get<std::uint64_t>() <=
+            std::uint64_t(std::numeric_limits<int>::max())) {
+            return value.get<int>();
+        }
+    } else if (value.is_number_integer()) {
+        std::int64_t number = value.get<std::int64_t>();
+        if (number >= std::numeric_limits<int>::min() &&
+            number <= std::numeric_limits<int>::max()) {
+            return int(number);
+        }
+    } else if (value.is_number()) {
+        double number = value.get<double>();
+        if (std::floor(number) == number &&
+            number >= double(std::numeric_limits<int>::min()) &&
+            number <= double(std::numeric_limits<int>::max())) {
+            return int(number);
+        }
+    }
+    throw InvalidParameterException(param,
+                                    std::string(key) + " must be an integer");
+}
+
+static double optionalNumber(const json &param, const char *key) {
+    if (!param.contains(key)) {
+        return 0.0;
+    }
+    if (!param[key].is_number()) {
+        throw InvalidParameterException(param,
+                                        std::string(key) + " must be a number");
+    }
+    return param[key].get<double>();
+}
+
+ScenarioEvent ScenarioEvent::fromJson(const json &param) {
+    if (!param.is_object()) {
+        throw InvalidParameterException(param, "event must be an object");
+    }
+    if (!param.contains("trigger_time")) {
+        throw InvalidParameterException(param,
+                                        "Missing required field: trigger_time");
+    }
+
+    ScenarioEvent event;
+    event.name = "未知事件";
+    if (param.contains("name")) {
+        if (!param["name"].is_string()) {
+            throw InvalidParameterException(param, "name must be a string");
+        }
+        event.name = param["name"].get<std::string>();
+    }
+    event.triggerTime = optionalInt(param, "trigger_time", 0);
+    if (event.triggerTime < 0 || event.triggerTime >= 1440) {
+        throw InvalidParameterException(
+            param, "trigger_time must be between 0 and 1439");
+    }
+    event.period = optionalInt(param, "period", 0);
+    if (event.period < 0) {
+        throw InvalidParameterException(param, "period must not be negative");
+    }
+    event.duration = optionalInt(param, "duration", 0);
+    if (event.duration < 0) {
+        throw InvalidParameterException(param, "duration must not be negative");
+    }
+    event.deltaTemperature = optionalNumber(param, "delta_temperature");
+    event.deltaHumidity = optionalNumber(param, "delta_humidity");
+    event.deltaCO2 = optionalNumber(param, "delta_co2");
+
+    if (param.contains("room")) {
+        if (!param["room"].is_string()) {
+            throw InvalidParameterException(param, "room must be a string");
+        }
+        event.room = param["room"].get<std::string>();
+    }
+    event.deviceId = optionalInt(param, "device_id", -1);
+    if (param.contains("device_state")) {
+        if (!param["device_state"].is_boolean()) {
+            throw InvalidParameterException(param,
+                                            "device_state must be a boolean");
+        }
+        event.state = param["device_state"].get<bool>();
+    }
+    return event;
+}
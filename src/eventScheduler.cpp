@@ -0,0 +1,84 @@
+#include "eventScheduler.h"
+#include <algorithm>
+#include <thread>
+
+bool EventScheduler::Later::operator()(const Entry &a, const Entry &b) const {
+    if (a.time != b.time) {
+        return a.time > b.time;
+    }
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    return a.sequence > b.sequence;
+}
+
+EventScheduler::EventScheduler()
+    : currentTime(0), nextSequence(0), stopped(false),
+      pacing(SimulationPacing::AsFastAsPossible), tickDuration(0) {}
+
+void EventScheduler::setPacing(SimulationPacing pacing,
+                               std::chrono::microseconds tickDuration) {
+    this->pacing = pacing;
+    this->tickDuration = tickDuration;
+}
+
+void EventScheduler::schedule(SimTime time, int priority, Action action) {
+    // 不允许安排到过去，过期的动作在当前时刻执行
+    queue.push_back(Entry{std::max(time, currentTime), priority,
+                          nextSequence++, std::move(action)});
+    std::push_heap(queue.begin(), queue.end(), Later());
+}
+
+void EventScheduler::scheduleEvery(SimTime start, SimTime period, SimTime end,
+                                   int priority, Action action) {
+    schedulePeriodic(start, period, end, priority, 0,
+                     std::make_shared<Action>(std::move(action)));
+}
+
+void EventScheduler::schedulePeriodic(SimTime start, SimTime period,
+                                      SimTime end, int priority,
+                                      std::int64_t n,
+                                      std::shared_ptr<Action> action) {
+    // 第 n 次的时刻直接由 start + n * period 算出，不累积误差
+    SimTime time = start + n * period;
+    if (time >= end) {
+        return;
+    }
+    schedule(time, priority, [=]() {
+        (*action)();
+        schedulePeriodic(start, period, end, priority, n + 1, action);
+    });
+}
+
+std::size_t EventScheduler::runUntil(SimTime end) {
+    stopped = false;
+    SimTime wallOrigin = currentTime;
+    auto wallStart = std::chrono::steady_clock::now();
+    std::size_t executed = 0;
+    while (!stopped && !queue.empty() && queue.front().time < end) {
+        std::pop_heap(queue.begin(), queue.end(), Later());
+        Entry entry = std::move(queue.back());
+        queue.pop_back();
+        if (pacing == SimulationPacing::RealTime &&
+            entry.time > currentTime) {
+            std::this_thread::sleep_until(
+                wallStart + tickDuration * (entry.time - wallOrigin));
+        }
+        currentTime = entry.time;
+        entry.action();
+        ++executed;
+    }
+    if (!stopped) {
+        currentTime = std::max(currentTime, end);
+    }
+    return executed;
+}
+
+void EventScheduler::stop() { stopped = true; }
+
+void EventScheduler::reset() {
+    queue.clear();
+    currentTime = 0;
+    nextSequence = 0;
+    stopped = false;
+}
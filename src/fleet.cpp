@@ -0,0 +1,194 @@
+#include "fleet.h"
+#include "SmartLogger.h"
+#include "documentFormat.h"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+Room *Home::addRoom(StorageMode storageMode) {
+    rooms.push_back(std::make_unique<Room>());
+    rooms.back()->init(storageMode, RemovalMode::SwapAndPop);
+    rooms.back()->setName("Room" + std::to_string(rooms.size() - 1));
+    return rooms.back().get();
+}
+
+Home *Fleet::addHome(const std::string &name) {
+    homes.push_back(std::make_unique<Home>(name));
+    return homes.back().get();
+}
+
+void Fleet::populate(int homes, int roomsPerHome, json &inventory,
+                     ThreadPool *pool) {
+    for (int h = 0; h < homes; ++h) {
+        Home *home = addHome("Home" + std::to_string(getHomeCount()));
+        for (int r = 0; r < roomsPerHome; ++r) {
+            Room *room = home->addRoom();
+            if (pool) {
+                room->setThreadPool(pool);
+            }
+            room->loadDevices(inventory);
+        }
+    }
+}
+
+int Fleet::getRoomCount() const {
+    int count = 0;
+    for (auto &home : homes) {
+        count += home->getRoomCount();
+    }
+    return count;
+}
+
+// 房间内处于开启状态的设备功率之和（W）
+template <typename T>
+static double activePower(const DeviceContainer<T> &container) {
+    double power = 0.0;
+    container.forEach([&](T *device) {
+        if (device->getState()) {
+            power += device->getPowerConsumption();
+        }
+    });
+    return power;
+}
+
+FleetReport Fleet::simulate(const json &envConfig, int days, ThreadPool &pool,
+                            int batchSize) {
+    auto wallStart = std::chrono::steady_clock::now();
+    std::vector<Room *> rooms;
+    for (auto &home : homes) {
+        for (int r = 0; r < home->getRoomCount(); ++r) {
+            rooms.push_back(home->getRoom(r));
+        }
+    }
+
+    std::vector<std::unique_ptr<SceneSimulation>> simulations;
+    for (Room *room : rooms) {
+        auto simulation = std::make_unique<SceneSimulation>(room);
+        simulation->setQuiet(true);
+        // 房间本身已在 pool 上并行推进，设备较多的房间再把批量更新分段
+        simulation->setThreadPool(&pool);
+        simulation->loadEnvironmentConfig(envConfig);
+        // 配置中的推进方式只针对单个房间的交互模拟
+        simulation->setPacing(SimulationPacing::AsFastAsPossible);
+        simulation->setDeterministic(false);
+        simulation->begin(days);
+        simulations.push_back(std::move(simulation));
+    }
+
+    FleetReport report;
+    report.rooms = int(rooms.size());
+    int minutes = days * SceneSimulation::MINUTES_PER_DAY;
+    report.ticks.resize(minutes);
+
+    // 任务图只构建一次，每分钟重新运行；各任务通过 minute 读取当前分钟
+    int minute = 0;
+    int batches = (int(rooms.size()) + batchSize - 1) / batchSize;
+    std::vector<FleetTickStats> partial(batches);
+    TaskGraph graph;
+    std::vector<TaskGraph::TaskId> batchTasks;
+    for (int b = 0; b < batches; ++b) {
+        batchTasks.push_back(graph.add([&, b]() {
+            SimTime until =
+                SimTime(minute + 1) * SceneSimulation::CONTROL_STEPS_PER_MINUTE;
+            FleetTickStats &stats = partial[b];
+            stats = FleetTickStats();
+            int end = std::min(int(rooms.size()), (b + 1) * batchSize);
+            for (int i = b * batchSize; i < end; ++i) {
+                SceneSimulation &simulation = *simulations[i];
+                simulation.advance(until);
+                double power = activePower(*rooms[i]->getLights()) +
+                               activePower(*rooms[i]->getSensors()) +
+                               activePower(*rooms[i]->getAirConditioners());
+                stats.energyWh += power / 60.0;
+                double error = std::abs(simulation.getTemperature() -
+                                        simulation.getTargetTemperature());
+                stats.comfortError += error;
+                if (error >= AIR_CONDITIONER_DEAD_BAND) {
+                    ++stats.roomsOutOfComfort;
+                }
+                if (simulation.isEmergency()) {
+                    ++stats.roomsInEmergency;
+                }
+            }
+        }));
+    }
+    graph.add(
+        [&]() {
+            FleetTickStats &tick = report.ticks[minute];
+            tick.minute = minute;
+            for (const FleetTickStats &stats : partial) {
+                tick.energyWh += stats.energyWh;
+                tick.comfortError += stats.comfortError;
+                tick.roomsOutOfComfort += stats.roomsOutOfComfort;
+                tick.roomsInEmergency += stats.roomsInEmergency;
+            }
+        },
+        batchTasks);
+
+    for (minute = 0; minute < minutes; ++minute) {
+        graph.run(pool);
+    }
+    for (auto &simulation : simulations) {
+        simulation->finish();
+    }
+
+    double comfortError = 0.0;
+    for (const FleetTickStats &tick : report.ticks) {
+        report.totalEnergyWh += tick.energyWh;
+        comfortError += tick.comfortError;
+        report.emergencyRoomMinutes += tick.roomsInEmergency;
+    }
+    if (!rooms.empty() && minutes > 0) {
+        report.meanComfortError = comfortError / rooms.size() / minutes;
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - wallStart;
+    report.wallSeconds = elapsed.count();
+    return report;
+}
+
+void fleetSimulation() {
+    LOG_INFO_SYS("开始批量模拟");
+    std::cout << "Fleet simulation\n";
+    int homes = 0, roomsPerHome = 0, days = 0;
+    std::cout << "请输入住宅户数、每户房间数与模拟天数: \n";
+    std::cin >> homes >> roomsPerHome >> days;
+    if (!std::cin || homes <= 0 || roomsPerHome <= 0 || days <= 0) {
+        std::cin.clear();
+        LOG_ALERT_SYS("批量模拟参数无效");
+        std::cout << "参数无效" << std::endl;
+        return;
+    }
+    std::cout << "请输入每个房间的设备文件名称与环境配置文件名称(data文件夹里): \n";
+    std::string deviceFile, envFile;
+    std::cin >> deviceFile >> envFile;
+
+    try {
+        DocumentFormat deviceFormat, envFormat;
+        std::ifstream deviceStream(
+            resolveDocumentPath("../data/", deviceFile, deviceFormat),
+            std::ios::binary);
+        json inventory = readDocument(deviceStream, deviceFormat);
+        std::ifstream envStream(resolveDocumentPath("../data/", envFile, envFormat),
+                                std::ios::binary);
+        json envConfig = readDocument(envStream, envFormat);
+
+        // 线程池先于房间创建，房间析构时它仍然有效
+        ThreadPool pool;
+        Fleet fleet;
+        fleet.populate(homes, roomsPerHome, inventory, &pool);
+        LOG_INFO_SYS("批量模拟 " + std::to_string(fleet.getRoomCount()) +
+                     " 个房间, " + std::to_string(days) + " 天, " +
+                     std::to_string(pool.size()) + " 个工作线程");
+        FleetReport report = fleet.simulate(envConfig, days, pool);
+
+        LOG_INFO_SYS("批量模拟完成，用时 " + std::to_string(report.wallSeconds) + " 秒");
+        LOG_INFO_SYS("  总耗电量: " + std::to_string(report.totalEnergyWh / 1000.0) + " kWh");
+        LOG_INFO_SYS("  平均温差: " + std::to_string(report.meanComfortError) + " ℃");
+        LOG_INFO_SYS("  紧急状态累计: " + std::to_string(report.emergencyRoomMinutes) + " 房间·分钟");
+    } catch (const std::exception &e) {
+        LOG_ALERT_SYS("批量模拟失败: " + std::string(e.what()));
+        std::cout << "批量模拟失败: " << e.what() << std::endl;
+    }
+}
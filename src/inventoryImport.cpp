@@ -0,0 +1,201 @@
+#include "inventoryImport.h"
+#include "exception.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *const SECTION_NAMES[] = {"Sensors", "Lights", "AirConditioners"};
+const DeviceType SECTION_TYPES[] = {DeviceType::Sensor, DeviceType::Light,
+                                    DeviceType::AirConditioner};
+const int SECTION_COUNT = 3;
+
+int sectionIndex(const std::string &key) {
+    for (int i = 0; i < SECTION_COUNT; ++i) {
+        if (key == SECTION_NAMES[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 只为当前设备元素构建 json，段和根对象本身不落地。
+// depth 为当前所在容器的层数：根对象内为 1，段数组内为 2
+class InventorySax : public nlohmann::json_sax<json> {
+  public:
+    using Callback = std::function<void(DeviceType, json &)>;
+
+    explicit InventorySax(const Callback &onDevice) : onDevice(onDevice) {}
+
+    InventoryCounts counts;
+    bool seen[SECTION_COUNT] = {false, false, false};
+
+    bool null() override { return value(json()); }
+    bool boolean(bool val) override { return value(json(val)); }
+    bool number_integer(number_integer_t val) override { return value(json(val)); }
+    bool number_unsigned(number_unsigned_t val) override { return value(json(val)); }
+    bool number_float(number_float_t val, const string_t &) override {
+        return value(json(val));
+    }
+    bool string(string_t &val) override { return value(json(std::move(val))); }
+    bool binary(binary_t &val) override {
+        return value(json::binary(std::move(val)));
+    }
+
+    bool start_object(std::size_t) override {
+        if (depth == 0) {
+            depth = 1;
+            return true;
+        }
+        if (building() || inSection()) {
+            open(json::object());
+        } else if (depth == 1) {
+            sectionValueIsNotArray();
+        }
+        ++depth;
+        return true;
+    }
+
+    bool key(string_t &val) override {
+        if (building()) {
+            pendingKey = std::move(val);
+        } else if (depth == 1) {
+            section = sectionIndex(val);
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        --depth;
+        close();
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (depth == 0) {
+            throw InvalidParameterException(json::array(),
+                                            "inventory must be an object");
+        }
+        if (building() || inSection()) {
+            open(json::array());
+        } else if (depth == 1 && section >= 0) {
+            seen[section] = true;
+        }
+        ++depth;
+        return true;
+    }
+
+    bool end_array() override {
+        --depth;
+        if (building()) {
+            close();
+        } else if (depth == 1) {
+            section = -1;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string &,
+                     const nlohmann::detail::exception &ex) override {
+        if (auto *error = dynamic_cast<const json::parse_error *>(&ex)) {
+            throw *error;
+        }
+        if (auto *error = dynamic_cast<const json::out_of_range *>(&ex)) {
+            throw *error;
+        }
+        throw std::runtime_error(ex.what());
+    }
+
+  private:
+    const Callback &onDevice;
+    int depth = 0;
+    int section = -1;          // 根对象中当前键对应的段，-1 表示其他键
+    json element;              // 正在构建的设备元素
+    std::vector<json *> stack; // element 中尚未结束的容器
+    string_t pendingKey;
+
+    bool building() const { return !stack.empty(); }
+    // 位于某个设备段数组的直接下层，即将开始一个设备元素
+    bool inSection() const { return depth == 2 && section >= 0; }
+
+    bool value(json &&val) {
+        if (building()) {
+            insert(std::move(val));
+        } else if (inSection()) {
+            emit(val); // 非对象元素交给工厂，由工厂报告参数错误
+        } else if (depth == 0) {
+            throw InvalidParameterException(val, "inventory must be an object");
+        } else if (depth == 1) {
+            sectionValueIsNotArray();
+        }
+        return true;
+    }
+
+    json *insert(json &&val) {
+        json &parent = *stack.back();
+        if (parent.is_object()) {
+            return &(parent[pendingKey] = std::move(val));
+        }
+        parent.push_back(std::move(val));
+        return &parent.back();
+    }
+
+    void open(json &&container) {
+        if (building()) {
+            stack.push_back(insert(std::move(container)));
+        } else {
+            element = std::move(container);
+            stack.push_back(&element);
+        }
+    }
+
+    void close() {
+        if (!building()) {
+            return;
+        }
+        stack.pop_back();
+        if (!building()) {
+            emit(element);
+            element = json();
+        }
+    }
+
+    void emit(json &device) {
+        switch (SECTION_TYPES[section]) {
+        case DeviceType::Sensor:
+            ++counts.sensors;
+            break;
+        case DeviceType::Light:
+            ++counts.lights;
+            break;
+        case DeviceType::AirConditioner:
+            ++counts.airConditioners;
+            break;
+        }
+        onDevice(SECTION_TYPES[section], device);
+    }
+
+    void sectionValueIsNotArray() {
+        if (section >= 0) {
+            throw InvalidParameterException(
+                json(), std::string(SECTION_NAMES[section]) + " must be an array");
+        }
+    }
+};
+
+} // namespace
+
+InventoryCounts streamInventory(
+    std::istream &in,
+    const std::function<void(DeviceType type, json &device)> &onDevice,
+    DocumentFormat format) {
+    InventorySax sax(onDevice);
+    json::sax_parse(in, &sax, saxInputFormat(format));
+    for (int i = 0; i < SECTION_COUNT; ++i) {
+        if (!sax.seen[i]) {
+            throw InvalidParameterException(
+                json(), std::string("Missing device section: ") + SECTION_NAMES[i]);
+        }
+    }
+    return sax.counts;
+}
@@ -0,0 +1,323 @@
+#include "inventorySnapshot.h"
+#include "common.h"
+#include "exception.h"
+#include "mappedFile.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+static const char MAGIC[8] = {'H', 'S', 'I', 'N', 'V', 0, 0, 0};
+static const std::size_t RECORD_SIZES[3] = {
+    sizeof(SensorRecord), sizeof(LightRecord), sizeof(AirConditionerRecord)};
+
+static std::size_t sectionIndex(DeviceType type) {
+    switch (type) {
+    case DeviceType::Sensor:
+        return 0;
+    case DeviceType::Light:
+        return 1;
+    case DeviceType::AirConditioner:
+        return 2;
+    }
+    return 0;
+}
+
+static std::uint64_t alignTo8(std::uint64_t offset) {
+    return (offset + 7) & ~std::uint64_t(7);
+}
+
+InventorySnapshotView::InventorySnapshotView(const char *data,
+                                             std::size_t size)
+    : data(data) {
+    if (size < sizeof(header)) {
+        throw std::runtime_error("inventory snapshot is truncated");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("not an inventory snapshot");
+    }
+    if (header.version != INVENTORY_SNAPSHOT_VERSION ||
+        header.headerSize != sizeof(header)) {
+        throw std::runtime_error("unsupported inventory snapshot version " +
+                                 std::to_string(header.version));
+    }
+    // 各段必须完整落在文件内，乘法先按上限排除溢出
+    for (int i = 0; i < 3; ++i) {
+        if (header.offsets[i] > size ||
+            header.counts[i] > (size - header.offsets[i]) / RECORD_SIZES[i]) {
+            throw std::runtime_error("inventory snapshot section out of range");
+        }
+    }
+    if (header.stringsOffset > size ||
+        header.stringsSize > size - header.stringsOffset) {
+        throw std::runtime_error("inventory snapshot string table out of range");
+    }
+}
+
+std::size_t InventorySnapshotView::count(DeviceType type) const {
+    return std::size_t(header.counts[sectionIndex(type)]);
+}
+
+SensorRecord InventorySnapshotView::sensor(std::size_t index) const {
+    SensorRecord record;
+    std::memcpy(&record, data + header.offsets[0] + index * sizeof(record),
+                sizeof(record));
+    return record;
+}
+
+LightRecord InventorySnapshotView::light(std::size_t index) const {
+    LightRecord record;
+    std::memcpy(&record, data + header.offsets[1] + index * sizeof(record),
+                sizeof(record));
+    return record;
+}
+
+AirConditionerRecord
+InventorySnapshotView::airConditioner(std::size_t index) const {
+    AirConditionerRecord record;
+    std::memcpy(&record, data + header.offsets[2] + index * sizeof(record),
+                sizeof(record));
+    return record;
+}
+
+std::string_view
+InventorySnapshotView::name(const SnapshotDeviceFields &fields) const {
+    if (fields.nameOffset > header.stringsSize ||
+        fields.nameLength > header.stringsSize - fields.nameOffset) {
+        throw std::runtime_error("inventory snapshot name out of range");
+    }
+    return std::string_view(data + header.stringsOffset + fields.nameOffset,
+                            fields.nameLength);
+}
+
+namespace {
+
+// 设备名称去重后依次放入字符串表
+class StringTable {
+  public:
+    SnapshotDeviceFields fields(Device *device) {
+        std::string name = device->getName();
+        auto it = offsets.find(name);
+        std::uint32_t offset;
+        if (it != offsets.end()) {
+            offset = it->second;
+        } else {
+            if (text.size() + name.size() > UINT32_MAX) {
+                throw std::runtime_error("inventory snapshot string table is too large");
+            }
+            offset = std::uint32_t(text.size());
+            text += name;
+            offsets.emplace(name, offset);
+        }
+        SnapshotDeviceFields result;
+        result.nameOffset = offset;
+        result.nameLength = std::uint32_t(name.size());
+        result.priorityLevel = device->getPriorityLevel();
+        result.updateFrequency = device->getUpdateFrequency();
+        result.powerConsumption = device->getPowerConsumption();
+        return result;
+    }
+
+    const std::string &contents() const { return text; }
+
+  private:
+    std::string text;
+    std::unordered_map<std::string, std::uint32_t> offsets;
+};
+
+template <typename Record>
+void appendRecord(std::vector<char> &image, const Record &record) {
+    const char *bytes = reinterpret_cast<const char *>(&record);
+    image.insert(image.end(), bytes, bytes + sizeof(record));
+}
+
+void pad(std::vector<char> &image) {
+    image.resize(std::size_t(alignTo8(image.size())), 0);
+}
+
+} // namespace
+
+void saveInventorySnapshot(const std::string &path,
+                           const SensorContainer &sensors,
+                           const LightContainer &lights,
+                           const AirConditionerContainer &airConditioners) {
+    DeviceRange<Sensor> sensorRange = sensors.getRange();
+    DeviceRange<Light> lightRange = lights.getRange();
+    DeviceRange<AirConditioner> acRange = airConditioners.getRange();
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = INVENTORY_SNAPSHOT_VERSION;
+    header.headerSize = sizeof(header);
+    header.counts[0] = std::uint64_t(sensorRange.size());
+    header.counts[1] = std::uint64_t(lightRange.size());
+    header.counts[2] = std::uint64_t(acRange.size());
+    std::uint64_t offset = sizeof(header);
+    for (int i = 0; i < 3; ++i) {
+        header.offsets[i] = offset;
+        offset = alignTo8(offset + header.counts[i] * RECORD_SIZES[i]);
+    }
+    header.stringsOffset = offset;
+
+    std::vector<char> image(sizeof(header));
+    image.reserve(std::size_t(offset));
+    StringTable strings;
+    for (Sensor *sensor : sensorRange) {
+        SensorReadings readings = sensor->getReadings();
+        SensorRecord record = {strings.fields(sensor), readings.temperature,
+                               readings.humidity, readings.CO2_Concentration};
+        appendRecord(image, record);
+    }
+    pad(image);
+    for (Light *light : lightRange) {
+        LightRecord record = {strings.fields(light), light->getLightness()};
+        appendRecord(image, record);
+    }
+    pad(image);
+    for (AirConditioner *ac : acRange) {
+        AirConditionerRecord record = {strings.fields(ac),
+                                       ac->getTargetTemperature(),
+                                       ac->getSpeed(),
+                                       std::uint8_t(ac->getModeValue()),
+                                       {0, 0, 0, 0, 0, 0, 0}};
+        appendRecord(image, record);
+    }
+    pad(image);
+    header.stringsSize = strings.contents().size();
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(image.data(), std::streamsize(image.size()));
+    out.write(strings.contents().data(),
+              std::streamsize(strings.contents().size()));
+    if (!out) {
+        throw std::runtime_error("cannot write inventory snapshot: " + path);
+    }
+}
+
+namespace {
+
+json deviceJson(const SnapshotDeviceFields &fields, std::string_view name) {
+    return {{"name", std::string(name)},
+            {"priorityLevel", fields.priorityLevel},
+            {"powerConsumption", fields.powerConsumption},
+            {"updateFrequency", fields.updateFrequency}};
+}
+
+// 取值范围与各工厂的 createDevice(const json &) 一致。条件写成
+// "在范围内"的形式，NaN 同样视为越界；出错信息只在越界时才生成
+void checkRange(double value, int low, int high, const char *field,
+                const SnapshotDeviceFields &fields, std::string_view name) {
+    if (!(value >= low && value <= high)) {
+        throw InvalidParameterException(
+            deviceJson(fields, name), std::string(field) + " must be between " +
+                                          std::to_string(low) + " and " +
+                                          std::to_string(high));
+    }
+}
+
+void checkDevice(const SnapshotDeviceFields &fields, std::string_view name) {
+    checkRange(fields.priorityLevel, 0, MAX_PRIORITY_LEVEL, "'priorityLevel'",
+               fields, name);
+    checkRange(fields.powerConsumption, 0, MAX_POWER_CONSUMPTION,
+               "'powerConsumption'", fields, name);
+    checkRange(fields.updateFrequency, 100, 60000, "'updateFrequency'", fields,
+               name);
+}
+
+// 逐条创建设备加入容器，整段只发布一次
+template <typename Container, typename Create>
+void loadSection(Container &container, std::size_t count, int &loaded,
+                 Create create) {
+    container.reserve(int(count));
+    container.beginBatch();
+    try {
+        for (std::size_t i = 0; i < count; ++i) {
+            container.addDevice(create(i));
+            ++loaded;
+        }
+    } catch (...) {
+        container.endBatch();
+        throw;
+    }
+    container.endBatch();
+}
+
+} // namespace
+
+Sensor *createFromRecord(SensorFactory &factory, const SensorRecord &r,
+                         std::string_view name) {
+    checkDevice(r.device, name);
+    checkRange(r.temperature, MIN_TEMPERATURE, MAX_TEMPERATURE, "temperature",
+               r.device, name);
+    checkRange(r.humidity, 0, MAX_HUMIDITY, "humidity", r.device, name);
+    checkRange(r.CO2_Concentration, 0, MAX_CO2_CONCENTRATION,
+               "CO2_Concentration", r.device, name);
+    return factory.create(std::string(name), r.device.priorityLevel,
+                          r.device.powerConsumption,
+                          {r.temperature, r.humidity, r.CO2_Concentration},
+                          r.device.updateFrequency);
+}
+
+Light *createFromRecord(LightFactory &factory, const LightRecord &r,
+                        std::string_view name) {
+    checkDevice(r.device, name);
+    checkRange(r.lightness, 0, MAX_LIGHTNESS, "'lightness'", r.device, name);
+    return factory.create(std::string(name), r.device.priorityLevel,
+                          r.device.powerConsumption, r.lightness,
+                          r.device.updateFrequency);
+}
+
+AirConditioner *createFromRecord(AirConditionerFactory &factory,
+                                 const AirConditionerRecord &r,
+                                 std::string_view name) {
+    checkDevice(r.device, name);
+    checkRange(r.targetTemperature, MIN_AIR_CONDITIONER_TEMPERATURE,
+               MAX_AIR_CONDITIONER_TEMPERATURE, "targetTemperature", r.device,
+               name);
+    checkRange(r.speed, 0, MAX_AIR_CONDITIONER_SPEED, "speed", r.device, name);
+    checkRange(r.mode, 0, int(AirConditionerMode::Heat), "mode", r.device,
+               name);
+    return factory.create(std::string(name), r.device.priorityLevel,
+                          r.device.powerConsumption, r.targetTemperature,
+                          r.speed, AirConditionerMode(r.mode),
+                          r.device.updateFrequency);
+}
+
+InventoryCounts loadInventorySnapshot(const std::string &path,
+                                      SensorContainer &sensors,
+                                      LightContainer &lights,
+                                      AirConditionerContainer &airConditioners) {
+    MappedFile file;
+    if (!file.open(path)) {
+        throw std::runtime_error("cannot open inventory snapshot: " + path);
+    }
+    InventorySnapshotView view(file.data(), file.size());
+    InventoryCounts counts;
+
+    auto *sensorFactory = static_cast<SensorFactory *>(sensors.getFactory());
+    loadSection(sensors, view.count(DeviceType::Sensor), counts.sensors,
+                [&](std::size_t i) {
+                    SensorRecord r = view.sensor(i);
+                    return createFromRecord(*sensorFactory, r, view.name(r.device));
+                });
+
+    auto *lightFactory = static_cast<LightFactory *>(lights.getFactory());
+    loadSection(lights, view.count(DeviceType::Light), counts.lights,
+                [&](std::size_t i) {
+                    LightRecord r = view.light(i);
+                    return createFromRecord(*lightFactory, r, view.name(r.device));
+                });
+
+    auto *acFactory =
+        static_cast<AirConditionerFactory *>(airConditioners.getFactory());
+    loadSection(airConditioners, view.count(DeviceType::AirConditioner),
+                counts.airConditioners, [&](std::size_t i) {
+                    AirConditionerRecord r = view.airConditioner(i);
+                    return createFromRecord(*acFactory, r, view.name(r.device));
+                });
+    return counts;
+}
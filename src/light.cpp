@@ -3,9 +3,25 @@
 #include "exception.h"
 #include <iostream>
 
-double Light::getLightness() const { return lightness; }
+double Light::getLightness() const {
+    return field(LIGHTNESS_FIELD, lightness).load(std::memory_order_relaxed);
+}
+
+void Light::setLightness(double lightness) {
+    field(LIGHTNESS_FIELD, this->lightness)
+        .store(lightness, std::memory_order_relaxed);
+}
 
-void Light::setLightness(double lightness) { this->lightness = lightness; }
+void Light::saveFieldsToColumns() {
+    column.block->fields[LIGHTNESS_FIELD][column.index].store(
+        lightness.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void Light::loadFieldsFromColumns() {
+    lightness.store(column.block->fields[LIGHTNESS_FIELD][column.index].load(
+                        std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+}
 
 DeviceType Light::getDeviceType() const { return DeviceType::Light; }
 
@@ -14,14 +30,14 @@ void Light::update() { return; }
 json Light::toJson() const {
     return {{"id", id},
             {"name", name},
-            {"priorityLevel", priorityLevel},
-            {"powerConsumption", powerConsumption},
-            {"updateFrequency", updateFrequency},
-            {"lightness", lightness}};
+            {"priorityLevel", getPriorityLevel()},
+            {"powerConsumption", getPowerConsumption()},
+            {"updateFrequency", getUpdateFrequency()},
+            {"lightness", getLightness()}};
 }
 
 Device *LightFactory::createDevice() {
-    Light *light = new Light("Light", 0, 20.0, 0.5);
+    Light *light = pool.create("Light", 0, 20.0, 0.5);
     return light;
 }
 
@@ -55,10 +71,27 @@ Device *LightFactory::createDevice(const json &param) {
     // 获取updateFrequency，如果不存在则使用默认值
     int updateFrequency = param.value("updateFrequency", 1000);
 
-    return new Light(name, priorityLevel, powerConsumption, lightness,
-                     updateFrequency);
+    return pool.create(name, priorityLevel, powerConsumption, lightness,
+                       updateFrequency);
 }
 
+Light *LightFactory::create(const std::string &name, int priorityLevel,
+                            double powerConsumption, double lightness,
+                            int updateFrequency) {
+    return pool.create(name, priorityLevel, powerConsumption, lightness,
+                       updateFrequency);
+}
+
+void LightFactory::destroyDevice(Device *device) {
+    if (pool.owns(device)) {
+        pool.destroy(static_cast<Light *>(device));
+    } else {
+        delete device;
+    }
+}
+
+void LightFactory::reserve(int count) { pool.reserve(count); }
+
 void LightContainer::changeDevice(int id) {
     Light *light = dynamic_cast<Light *>(getDevice(id));
     if (light) {
@@ -0,0 +1,82 @@
+#include "logFormats.h"
+
+const char *logFormatPattern(LogFormat format) {
+    switch (format) {
+    case LogFormat::Text:
+        return "{}";
+    case LogFormat::AirConditionerState:
+        return "名称: {}, 状态: {}, 目标温度: {}, 模式: {}, 风速: {}";
+    case LogFormat::LightState:
+        return "名称: {}, 状态: {}, 亮度: {}%";
+    case LogFormat::SensorTemperature:
+        return "温度: {} ℃";
+    case LogFormat::SensorHumidity:
+        return "湿度: {} %";
+    case LogFormat::SensorCO2:
+        return "CO2: {} ppm";
+    case LogFormat::EnvironmentTemperature:
+        return "  温度: {} ℃";
+    case LogFormat::EnvironmentHumidity:
+        return "  湿度: {} %";
+    case LogFormat::EnvironmentCO2:
+        return "  CO2: {} ppm";
+    case LogFormat::SimulationClock:
+        return "\n================= [ {} ] =================";
+    case LogFormat::EventHeader:
+        return "\n********** 事件触发 [{}] **********";
+    case LogFormat::EventSummary:
+        return "事件: {} (温度{}{}, 湿度{}{}, CO2{}{})";
+    case LogFormat::EventSummaryTimed:
+        return "事件: {} (温度{}{}, 湿度{}{}, CO2{}{}) 在 {} 分钟内完成";
+    case LogFormat::EventDeviceState:
+        return "{}设备: {}";
+    case LogFormat::EmergencyCO2:
+        return "当前CO2浓度: {} ppm (阈值: {} ppm)";
+    case LogFormat::EmergencyStart:
+        return "紧急模式开始时间: {}";
+    case LogFormat::EmergencyRecovery:
+        return "预计恢复时间: {}";
+    case LogFormat::EmergencyDuration:
+        return "紧急模式将在 {} 分钟后自动恢复";
+    case LogFormat::AirConditionerShutdown:
+        return "已关闭空调: {}";
+    case LogFormat::LightShutdown:
+        return "已关闭灯光: {}";
+    case LogFormat::SensorShutdown:
+        return "已关闭传感器: {}";
+    case LogFormat::SensorRestart:
+        return "已重新开启传感器: {}";
+    default:
+        return nullptr;
+    }
+}
+
+std::string LogArg::toString() const {
+    switch (type) {
+    case Integer:
+        return std::to_string(integer);
+    case Real:
+        return std::to_string(real);
+    default:
+        return text;
+    }
+}
+
+std::string formatLogPattern(const std::string &pattern, const LogArg *args,
+                             std::size_t count) {
+    std::string result;
+    result.reserve(pattern.size() + count * 8);
+    std::size_t next = 0;
+    std::size_t pos = 0;
+    while (pos < pattern.size()) {
+        std::size_t hole = pattern.find("{}", pos);
+        if (hole == std::string::npos || next == count) {
+            result.append(pattern, pos, std::string::npos);
+            break;
+        }
+        result.append(pattern, pos, hole - pos);
+        result += args[next++].toString();
+        pos = hole + 2;
+    }
+    return result;
+}
@@ -1,8 +1,12 @@
 #include "SmartLogger.h"
+#include "binaryLog.h"
+#include "fleet.h"
 #include "room.h"
+#include "rotatingFileOutputter.h"
 #include <chrono>
 #include <iostream>
 #include <limits>
+#include <string>
 
 std::string getTimestampForFilename() {
     auto now = std::chrono::system_clock::now();
@@ -13,13 +17,24 @@ std::string getTimestampForFilename() {
     return ss.str();
 }
 
-int main() {
-    // 初始化日志系统
+int main(int argc, char *argv[]) {
+    // 初始化日志系统。--binary-log 时日志文件改为二进制格式，
+    // 用 homesphere-logdecode 还原为文本
+    bool binaryLog = argc > 1 && std::string(argv[1]) == "--binary-log";
     SmartLogger::getInstance()->setMinLevel(LogLevel::INFO);
-    std::string filename =
-        "../logs/simulation_" + getTimestampForFilename() + ".log";
-    SmartLogger::getInstance()->addOutputter(
-        std::make_unique<FileOutputter>(filename));
+    std::string filename = "../logs/simulation_" + getTimestampForFilename() +
+                           (binaryLog ? ".hslog" : ".log");
+    if (binaryLog) {
+        SmartLogger::getInstance()->setBinaryLog(
+            std::make_shared<BinaryLogWriter>(filename));
+    } else {
+        // 文本日志超过 64 MB 或满一天时滚动，保留最近 10 段归档
+        RotationPolicy policy;
+        policy.maxAge = std::chrono::hours(24);
+        policy.buffered = true;
+        SmartLogger::getInstance()->addOutputter(
+            std::make_unique<RotatingFileOutputter>(filename, policy));
+    }
     LOG_INFO_SYS("智能家居系统启动");
 
     Room room;
@@ -89,6 +104,9 @@ int main() {
             }
             room.roomSimulation();
             break;
+        case '9':
+            fleetSimulation();
+            break;
         case 'Q':
         case 'q':
             LOG_INFO_SYS("用户选择退出系统");
@@ -102,5 +120,8 @@ int main() {
     } while (choice != 'Q' && choice != 'q');
 
     LOG_INFO_SYS("智能家居系统关闭");
+    // 写出缓冲中的二进制日志；关闭文本日志文件并等待归档压缩完成
+    SmartLogger::getInstance()->setBinaryLog(nullptr);
+    SmartLogger::getInstance()->removeOutputters();
     return 0;
 }
\ No newline at end of file
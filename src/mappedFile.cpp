@@ -0,0 +1,59 @@
+#include "mappedFile.h"
+#include <fstream>
+#include <iterator>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const std::string &path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    std::size_t size = std::size_t(info.st_size);
+    if (size > 0) {
+        void *address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // 映射建立后不再需要文件描述符
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        close();
+        bytes = static_cast<const char *>(address);
+        length = size;
+        return true;
+    }
+    ::close(fd);
+#endif
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::vector<char> content((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+    close();
+    fallback.swap(content);
+    length = fallback.size();
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (bytes != nullptr) {
+        ::munmap(const_cast<char *>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+    fallback.clear();
+}
@@ -0,0 +1,211 @@
+#include "mappedInventory.h"
+#include <stdexcept>
+
+static const DeviceType SECTION_TYPES[3] = {
+    DeviceType::Sensor, DeviceType::Light, DeviceType::AirConditioner};
+
+static int sectionIndex(DeviceType type) {
+    switch (type) {
+    case DeviceType::Sensor:
+        return 0;
+    case DeviceType::Light:
+        return 1;
+    case DeviceType::AirConditioner:
+        return 2;
+    }
+    return 0;
+}
+
+MappedInventory::MappedInventory(const std::string &path) {
+    if (!file.open(path)) {
+        throw std::runtime_error("cannot open inventory snapshot: " + path);
+    }
+    view = std::make_unique<InventorySnapshotView>(file.data(), file.size());
+    std::size_t total = 0;
+    for (int i = 0; i < 3; ++i) {
+        sectionStart[i] = total;
+        sectionCount[i] = view->count(SECTION_TYPES[i]);
+        remaining[i] = sectionCount[i];
+        total += sectionCount[i];
+    }
+    if (total > std::size_t(INT32_MAX)) {
+        throw std::runtime_error("inventory snapshot has too many devices");
+    }
+    firstId = Device::reserveIds(int(total));
+    detached.assign(total, false);
+}
+
+std::size_t MappedInventory::count(DeviceType type) const {
+    return remaining[sectionIndex(type)];
+}
+
+std::size_t MappedInventory::size() const {
+    return remaining[0] + remaining[1] + remaining[2];
+}
+
+bool MappedInventory::contains(int id) const {
+    if (id < firstId) {
+        return false;
+    }
+    std::size_t position = std::size_t(id - firstId);
+    return position < detached.size() && !detached[position];
+}
+
+int MappedInventory::sectionOf(std::size_t position) const {
+    return position < sectionStart[1] ? 0 : position < sectionStart[2] ? 1 : 2;
+}
+
+DeviceType MappedInventory::typeOf(int id) const {
+    return SECTION_TYPES[sectionOf(std::size_t(id - firstId))];
+}
+
+json MappedInventory::deviceJson(int id) const {
+    std::size_t position = std::size_t(id - firstId);
+    int section = sectionOf(position);
+    std::size_t index = position - sectionStart[section];
+    auto common = [&](const SnapshotDeviceFields &fields) {
+        return json{{"id", id},
+                    {"name", std::string(view->name(fields))},
+                    {"priorityLevel", fields.priorityLevel},
+                    {"powerConsumption", fields.powerConsumption},
+                    {"updateFrequency", fields.updateFrequency}};
+    };
+    switch (section) {
+    case 0: {
+        SensorRecord r = view->sensor(index);
+        json j = common(r.device);
+        j["temperature"] = r.temperature;
+        j["humidity"] = r.humidity;
+        j["CO2_Concentration"] = r.CO2_Concentration;
+        return j;
+    }
+    case 1: {
+        LightRecord r = view->light(index);
+        json j = common(r.device);
+        j["lightness"] = r.lightness;
+        return j;
+    }
+    default: {
+        AirConditionerRecord r = view->airConditioner(index);
+        json j = common(r.device);
+        j["targetTemperature"] = r.targetTemperature;
+        j["speed"] = r.speed;
+        j["mode"] = r.mode <= std::uint8_t(AirConditionerMode::Heat)
+                        ? std::string(toString(AirConditionerMode(r.mode)))
+                        : std::to_string(r.mode);
+        return j;
+    }
+    }
+}
+
+void MappedInventory::appendJson(DeviceType type, json &devices) const {
+    int section = sectionIndex(type);
+    std::size_t end = sectionStart[section] + sectionCount[section];
+    for (std::size_t position = sectionStart[section]; position < end;
+         ++position) {
+        if (!detached[position]) {
+            devices.push_back(deviceJson(firstId + int(position)));
+        }
+    }
+}
+
+void MappedInventory::detach(int id) {
+    if (!contains(id)) {
+        return;
+    }
+    std::size_t position = std::size_t(id - firstId);
+    detached[position] = true;
+    --remaining[sectionOf(position)];
+}
+
+Device *MappedInventory::create(std::size_t position, SensorContainer &sensors,
+                                LightContainer &lights,
+                                AirConditionerContainer &airConditioners) {
+    int section = sectionOf(position);
+    std::size_t index = position - sectionStart[section];
+    // 设备直接使用打开快照时为它预留的 id，不占用全局计数器
+    Device::IdScope ids(firstId + int(position));
+    Device *device;
+    switch (section) {
+    case 0: {
+        SensorRecord r = view->sensor(index);
+        Sensor *sensor = createFromRecord(
+            *static_cast<SensorFactory *>(sensors.getFactory()), r,
+            view->name(r.device));
+        sensors.addDevice(sensor);
+        device = sensor;
+        break;
+    }
+    case 1: {
+        LightRecord r = view->light(index);
+        Light *light = createFromRecord(
+            *static_cast<LightFactory *>(lights.getFactory()), r,
+            view->name(r.device));
+        lights.addDevice(light);
+        device = light;
+        break;
+    }
+    default: {
+        AirConditionerRecord r = view->airConditioner(index);
+        AirConditioner *ac = createFromRecord(
+            *static_cast<AirConditionerFactory *>(airConditioners.getFactory()),
+            r, view->name(r.device));
+        airConditioners.addDevice(ac);
+        device = ac;
+        break;
+    }
+    }
+    detached[position] = true;
+    --remaining[section];
+    return device;
+}
+
+Device *MappedInventory::materialize(int id, SensorContainer &sensors,
+                                     LightContainer &lights,
+                                     AirConditionerContainer &airConditioners) {
+    if (!contains(id)) {
+        return nullptr;
+    }
+    return create(std::size_t(id - firstId), sensors, lights, airConditioners);
+}
+
+InventoryCounts
+MappedInventory::materializeAll(SensorContainer &sensors, LightContainer &lights,
+                                AirConditionerContainer &airConditioners) {
+    InventoryCounts counts;
+    sensors.reserve(int(remaining[0]));
+    lights.reserve(int(remaining[1]));
+    airConditioners.reserve(int(remaining[2]));
+    sensors.beginBatch();
+    lights.beginBatch();
+    airConditioners.beginBatch();
+    try {
+        for (std::size_t position = 0; position < detached.size();
+             ++position) {
+            if (detached[position]) {
+                continue;
+            }
+            switch (sectionOf(position)) {
+            case 0:
+                ++counts.sensors;
+                break;
+            case 1:
+                ++counts.lights;
+                break;
+            default:
+                ++counts.airConditioners;
+                break;
+            }
+            create(position, sensors, lights, airConditioners);
+        }
+    } catch (...) {
+        airConditioners.endBatch();
+        lights.endBatch();
+        sensors.endBatch();
+        throw;
+    }
+    airConditioners.endBatch();
+    lights.endBatch();
+    sensors.endBatch();
+    return counts;
+}
@@ -0,0 +1,173 @@
+#include "parallelImport.h"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// 一段文件中连续的同类设备，id 从 firstId 起依次分配
+struct ImportChunk {
+    DeviceType type;
+    int firstId = 0;
+    int idCount = 0; // 预留的 id 数，即元素个数
+    std::vector<json> elements;
+    std::vector<Device *> devices;
+    std::exception_ptr error; // 第一个无法创建的元素，devices 为它之前的设备
+};
+
+void buildChunk(ImportChunk &chunk, DeviceFactory *factory) {
+    Device::IdScope ids(chunk.firstId);
+    try {
+        chunk.devices.reserve(chunk.elements.size());
+        for (const json &element : chunk.elements) {
+            chunk.devices.push_back(factory->createDevice(element));
+        }
+    } catch (...) {
+        chunk.error = std::current_exception();
+    }
+    chunk.elements = std::vector<json>();
+}
+
+// 离开作用域时等待所有已提交的批次完成，任务引用的状态此后才能释放
+struct PendingChunks {
+    ThreadPool &pool;
+    std::atomic<std::size_t> count{0};
+
+    explicit PendingChunks(ThreadPool &pool) : pool(pool) {}
+    ~PendingChunks() { wait(0); }
+
+    void wait(std::size_t atMost) {
+        pool.waitUntil([this, atMost]() { return count <= atMost; });
+    }
+};
+
+} // namespace
+
+InventoryCounts importInventory(std::istream &in, DocumentFormat format,
+                                SensorContainer &sensors, LightContainer &lights,
+                                AirConditionerContainer &airConditioners,
+                                ThreadPool &pool, std::size_t chunkSize) {
+    auto factoryFor = [&](DeviceType type) -> DeviceFactory * {
+        switch (type) {
+        case DeviceType::Sensor:
+            return sensors.getFactory();
+        case DeviceType::Light:
+            return lights.getFactory();
+        case DeviceType::AirConditioner:
+            return airConditioners.getFactory();
+        }
+        return nullptr;
+    };
+
+    std::vector<std::unique_ptr<ImportChunk>> chunks; // 按文件顺序
+    std::unique_ptr<ImportChunk> current;
+    std::exception_ptr parseError;
+    {
+        PendingChunks pending(pool);
+        // 在途批次的上限，避免解析快于创建时元素在内存中堆积
+        const std::size_t maxPending = 2 * std::size_t(pool.size()) + 2;
+
+        // 提交当前批次。id 在解析线程上按顺序预留，与文件顺序一致
+        auto dispatch = [&]() {
+            if (!current) {
+                return;
+            }
+            ImportChunk *chunk = current.get();
+            chunk->idCount = int(chunk->elements.size());
+            chunk->firstId = Device::reserveIds(chunk->idCount);
+            DeviceFactory *factory = factoryFor(chunk->type);
+            chunks.push_back(std::move(current));
+            ++pending.count;
+            pool.submit([chunk, factory, &pending]() {
+                buildChunk(*chunk, factory);
+                --pending.count;
+            });
+            pending.wait(maxPending);
+        };
+
+        try {
+            streamInventory(in, [&](DeviceType type, json &device) {
+                if (current && current->type != type) {
+                    dispatch();
+                }
+                if (!current) {
+                    current = std::make_unique<ImportChunk>();
+                    current->type = type;
+                    current->elements.reserve(chunkSize);
+                }
+                current->elements.push_back(std::move(device));
+                if (current->elements.size() >= chunkSize) {
+                    dispatch();
+                }
+            }, format);
+        } catch (...) {
+            parseError = std::current_exception();
+        }
+        // 出错位置之前读到的设备同样创建
+        dispatch();
+    }
+
+    // 按文件顺序合并，第一个出错的批次之后的设备全部销毁
+    InventoryCounts counts;
+    std::exception_ptr error;
+    int unusedFrom = 0; // 出错时第一个没有加入容器的设备所预留的 id
+    sensors.beginBatch();
+    lights.beginBatch();
+    airConditioners.beginBatch();
+    auto endBatches = [&]() {
+        airConditioners.endBatch();
+        lights.endBatch();
+        sensors.endBatch();
+    };
+    try {
+        for (auto &chunk : chunks) {
+            if (error) {
+                DeviceFactory *factory = factoryFor(chunk->type);
+                for (Device *device : chunk->devices) {
+                    factory->destroyDevice(device);
+                }
+                continue;
+            }
+            for (Device *device : chunk->devices) {
+                switch (chunk->type) {
+                case DeviceType::Sensor:
+                    sensors.addDevice(static_cast<Sensor *>(device));
+                    ++counts.sensors;
+                    break;
+                case DeviceType::Light:
+                    lights.addDevice(static_cast<Light *>(device));
+                    ++counts.lights;
+                    break;
+                case DeviceType::AirConditioner:
+                    airConditioners.addDevice(
+                        static_cast<AirConditioner *>(device));
+                    ++counts.airConditioners;
+                    break;
+                }
+            }
+            error = chunk->error;
+            if (error) {
+                unusedFrom = chunk->firstId + int(chunk->devices.size());
+            }
+        }
+    } catch (...) {
+        endBatches();
+        throw;
+    }
+    endBatches();
+
+    // 出错时把之后未使用的 id 归还，导入期间其他线程又分配过 id 时只能留空
+    if (error) {
+        const ImportChunk &last = *chunks.back();
+        Device::releaseIds(unusedFrom, last.firstId + last.idCount);
+    }
+
+    if (!error) {
+        error = parseError;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return counts;
+}
@@ -1,30 +1,108 @@
 #include "room.h"
 #include "SmartLogger.h"
 #include "exception.h"
+#include "inventorySnapshot.h"
+#include "parallelImport.h"
 #include "sceneSimulation.h"
 #include <fstream>
+#include <sstream>
 #include <vector>
 
-void Room::init() {
+void Room::init(StorageMode storageMode, RemovalMode removalMode) {
     LOG_INFO_SYS("开始初始化房间设备容器");
 
     DeviceFactory *light_factory = new LightFactory();
     DeviceFactory *air_conditioner_factory = new AirConditionerFactory();
     DeviceFactory *sensor_factory = new SensorFactory();
 
-    lights = new LightContainer(light_factory);
-    airConditioners = new AirConditionerContainer(air_conditioner_factory);
-    sensors = new SensorContainer(sensor_factory);
+    // 重新初始化时旧的容器与设备随之释放
+    deviceDirectory.clear();
+    mapped.reset();
+    lights = std::make_unique<LightContainer>(light_factory);
+    airConditioners =
+        std::make_unique<AirConditionerContainer>(air_conditioner_factory);
+    sensors = std::make_unique<SensorContainer>(sensor_factory);
+
+    lights->setStorageMode(storageMode);
+    airConditioners->setStorageMode(storageMode);
+    sensors->setStorageMode(storageMode);
+    lights->setRemovalMode(removalMode);
+    airConditioners->setRemovalMode(removalMode);
+    sensors->setRemovalMode(removalMode);
+
+    admin = std::make_unique<Admin>("Admin");
+    lightAdmin = std::make_unique<LightAdmin>("LightAdmin");
+    sensorAdmin = std::make_unique<SensorAdmin>("SensorAdmin");
+    airConditionerAdmin =
+        std::make_unique<AirConditionerAdmin>("AirConditionerAdmin");
+    visitor = std::make_unique<Visitor>("Visitor");
+
+    currentUser = admin.get();
 
-    admin = new Admin("Admin");
-    lightAdmin = new LightAdmin("LightAdmin");
-    sensorAdmin = new SensorAdmin("SensorAdmin");
-    airConditionerAdmin = new AirConditionerAdmin("AirConditionerAdmin");
-    visitor = new Visitor("Visitor");
+    LOG_INFO_SYS("房间设备容器初始化完成");
+}
 
-    currentUser = admin;
+template <typename T>
+static void registerRange(std::unordered_map<int, DeviceType> &directory,
+                          const DeviceContainer<T> *container, DeviceType type,
+                          int from) {
+    DeviceRange<T> devices = container->getRange();
+    for (int i = from; i < devices.size(); ++i) {
+        directory[devices[i]->getId()] = type;
+    }
+}
 
-    LOG_INFO_SYS("房间设备容器初始化完成");
+// 将容器中下标 from 之后新加入的设备登记到设备目录
+void Room::registerDevices(DeviceType type, int from) {
+    switch (type) {
+    case DeviceType::Sensor:
+        registerRange(deviceDirectory, sensors.get(), type, from);
+        break;
+    case DeviceType::Light:
+        registerRange(deviceDirectory, lights.get(), type, from);
+        break;
+    case DeviceType::AirConditioner:
+        registerRange(deviceDirectory, airConditioners.get(), type, from);
+        break;
+    }
+}
+
+ThreadPool *Room::getThreadPool() {
+    if (!pool) {
+        ownedPool = std::make_unique<ThreadPool>();
+        pool = ownedPool.get();
+    }
+    return pool;
+}
+
+// 通过设备目录一次定位设备，无需逐个容器查找
+Device *Room::lookupDevice(int id) {
+    auto it = deviceDirectory.find(id);
+    if (it == deviceDirectory.end()) {
+        if (!mapped || !mapped->contains(id)) {
+            return nullptr;
+        }
+        // 映射清单中的设备在首次需要对象时单独创建（写时复制）
+        Device *device;
+        try {
+            device = mapped->materialize(id, *sensors, *lights,
+                                         *airConditioners);
+        } catch (const InvalidParameterException &e) {
+            LOG_ALERT_SYS("快照中的设备无法创建: " + std::string(e.what()));
+            return nullptr;
+        }
+        deviceDirectory[id] = device->getDeviceType();
+        return device;
+    }
+    switch (it->second) {
+    case DeviceType::Sensor:
+        return sensors->getDevice(id);
+    case DeviceType::Light:
+        return lights->getDevice(id);
+    case DeviceType::AirConditioner:
+        return airConditioners->getDevice(id);
+    }
+    return nullptr;
 }
 
 void Room::printCurrentUser() {
@@ -32,33 +110,42 @@ void Room::printCurrentUser() {
     currentUser->show();
 }
 
+// 以 .hsinv 结尾的文件名表示二进制快照，其余按不带后缀的 JSON 清单处理
+static bool isSnapshotName(const std::string &filename) {
+    const std::string suffix = ".hsinv";
+    return filename.size() > suffix.size() &&
+           filename.compare(filename.size() - suffix.size(), suffix.size(),
+                            suffix) == 0;
+}
+
 void Room::addDevicesFromFile() {
     LOG_INFO_SYS("开始从文件导入设备");
     std::cout << "Add devices from file\n";
-    std::cout << "请输入文件名称(data文件夹里): \n";
+    std::cout << "请输入文件名称(data文件夹里，不带后缀时读取 .json，"
+                 "也可带 .cbor/.msgpack/.bson/.ubj 或二进制快照 .hsinv 后缀): \n";
     std::string filename;
     std::cin >> filename;
 
-    std::string json_path = "../data/" + filename + ".json";
+    bool snapshot = isSnapshotName(filename);
+    DocumentFormat format = DocumentFormat::Json;
+    std::string json_path = snapshot ? "../data/" + filename
+                                     : resolveDocumentPath("../data/", filename,
+                                                           format);
     LOG_INFO_SYS("尝试加载设备配置文件: " + json_path);
 
     try {
-        std::ifstream ifs(json_path);
-        json j;
-        ifs >> j;
-        ifs.close();
-
-        int sensorCount = j["Sensors"].size();
-        int lightCount = j["Lights"].size();
-        int acCount = j["AirConditioners"].size();
-
-        sensors->addDevice(j["Sensors"]);
-        lights->addDevice(j["Lights"]);
-        airConditioners->addDevice(j["AirConditioners"]);
+        InventoryCounts counts;
+        if (snapshot) {
+            counts = attachSnapshot(json_path);
+        } else {
+            std::ifstream ifs(json_path, std::ios::binary);
+            counts = loadDevices(ifs, format, getThreadPool());
+            ifs.close();
+        }
 
-        LOG_INFO_SYS("设备导入成功 - 传感器: " + std::to_string(sensorCount) +
-                     ", 灯光: " + std::to_string(lightCount) +
-                     ", 空调: " + std::to_string(acCount));
+        LOG_INFO_SYS("设备导入成功 - 传感器: " + std::to_string(counts.sensors) +
+                     ", 灯光: " + std::to_string(counts.lights) +
+                     ", 空调: " + std::to_string(counts.airConditioners));
 
     } catch (const FactoryNotFoundException &e) {
         LOG_ALERT_SYS("工厂未找到异常: " + std::string(e.what()));
@@ -78,6 +165,143 @@ void Room::addDevicesFromFile() {
     }
 }
 
+void Room::loadDevices(json &inventory) {
+    int sensorFrom = sensors->getSize();
+    int lightFrom = lights->getSize();
+    int acFrom = airConditioners->getSize();
+    // 导入中途失败时已加入容器的设备同样需要登记
+    auto registerAll = [&]() {
+        registerDevices(DeviceType::Sensor, sensorFrom);
+        registerDevices(DeviceType::Light, lightFrom);
+        registerDevices(DeviceType::AirConditioner, acFrom);
+    };
+    try {
+        sensors->addDevice(inventory["Sensors"]);
+        lights->addDevice(inventory["Lights"]);
+        airConditioners->addDevice(inventory["AirConditioners"]);
+    } catch (...) {
+        registerAll();
+        throw;
+    }
+    registerAll();
+}
+
+InventoryCounts Room::loadDevices(std::istream &in, DocumentFormat format,
+                                  ThreadPool *pool) {
+    int sensorFrom = sensors->getSize();
+    int lightFrom = lights->getSize();
+    int acFrom = airConditioners->getSize();
+    auto registerAll = [&]() {
+        registerDevices(DeviceType::Sensor, sensorFrom);
+        registerDevices(DeviceType::Light, lightFrom);
+        registerDevices(DeviceType::AirConditioner, acFrom);
+    };
+    InventoryCounts counts;
+    if (pool) {
+        try {
+            counts = importInventory(in, format, *sensors, *lights,
+                                     *airConditioners, *pool);
+        } catch (...) {
+            registerAll();
+            throw;
+        }
+        registerAll();
+        return counts;
+    }
+
+    // 整个导入期间每个容器只在结束时发布一次
+    sensors->beginBatch();
+    lights->beginBatch();
+    airConditioners->beginBatch();
+    auto finish = [&]() {
+        airConditioners->endBatch();
+        lights->endBatch();
+        sensors->endBatch();
+        registerAll();
+    };
+    try {
+        counts = streamInventory(in, [this](DeviceType type, const json &device) {
+            switch (type) {
+            case DeviceType::Sensor:
+                sensors->importDevice(device);
+                break;
+            case DeviceType::Light:
+                lights->importDevice(device);
+                break;
+            case DeviceType::AirConditioner:
+                airConditioners->importDevice(device);
+                break;
+            }
+        }, format);
+    } catch (...) {
+        finish();
+        throw;
+    }
+    finish();
+    return counts;
+}
+
+InventoryCounts Room::loadSnapshot(const std::string &path) {
+    int sensorFrom = sensors->getSize();
+    int lightFrom = lights->getSize();
+    int acFrom = airConditioners->getSize();
+    auto registerAll = [&]() {
+        registerDevices(DeviceType::Sensor, sensorFrom);
+        registerDevices(DeviceType::Light, lightFrom);
+        registerDevices(DeviceType::AirConditioner, acFrom);
+    };
+    InventoryCounts counts;
+    try {
+        counts = loadInventorySnapshot(path, *sensors, *lights,
+                                       *airConditioners);
+    } catch (...) {
+        registerAll();
+        throw;
+    }
+    registerAll();
+    return counts;
+}
+
+InventoryCounts Room::attachSnapshot(const std::string &path) {
+    // 先打开新快照，失败时原有映射保持不变
+    auto inventory = std::make_unique<MappedInventory>(path);
+    materializeMapped();
+    mapped = std::move(inventory);
+
+    InventoryCounts counts;
+    counts.sensors = int(mapped->count(DeviceType::Sensor));
+    counts.lights = int(mapped->count(DeviceType::Light));
+    counts.airConditioners = int(mapped->count(DeviceType::AirConditioner));
+    return counts;
+}
+
+void Room::materializeMapped() {
+    if (!mapped) {
+        return;
+    }
+    int sensorFrom = sensors->getSize();
+    int lightFrom = lights->getSize();
+    int acFrom = airConditioners->getSize();
+    auto registerAll = [&]() {
+        registerDevices(DeviceType::Sensor, sensorFrom);
+        registerDevices(DeviceType::Light, lightFrom);
+        registerDevices(DeviceType::AirConditioner, acFrom);
+    };
+    try {
+        mapped->materializeAll(*sensors, *lights, *airConditioners);
+    } catch (...) {
+        registerAll();
+        throw;
+    }
+    registerAll();
+    mapped.reset();
+}
+
+void Room::saveSnapshot(const std::string &path) {
+    materializeMapped();
+    saveInventorySnapshot(path, *sensors, *lights, *airConditioners);
+}
+
 void Room::addDevices() {
     LOG_INFO_SYS("开始从键盘添加设备");
     std::cout << "Add devices\n";
@@ -87,6 +311,10 @@ void Room::addDevices() {
 
     LOG_INFO_SYS("准备添加 " + std::to_string(n) + " 个设备");
 
+    int sensorFrom = sensors->getSize();
+    int lightFrom = lights->getSize();
+    int acFrom = airConditioners->getSize();
+
     try {
         for (int i = 0; i < n; i++) {
             DeviceParam device_param;
@@ -138,6 +366,20 @@ void Room::addDevices() {
         LOG_ALERT_SYS("Other error: " + std::string(e.what()));
         std::cout << "Other error: " << e.what() << std::endl;
     }
+
+    registerDevices(DeviceType::Sensor, sensorFrom);
+    registerDevices(DeviceType::Light, lightFrom);
+    registerDevices(DeviceType::AirConditioner, acFrom);
+}
+
+// 把映射清单中剩余的设备追加到对应分组之后
+void Room::appendMapped(json &inventory) const {
+    if (!mapped) {
+        return;
+    }
+    mapped->appendJson(DeviceType::Sensor, inventory["Sensors"]);
+    mapped->appendJson(DeviceType::Light, inventory["Lights"]);
+    mapped->appendJson(DeviceType::AirConditioner, inventory["AirConditioners"]);
 }
 
 void Room::showDevices() {
@@ -151,6 +393,13 @@ void Room::showDevices() {
                      "设备能耗)\n";
         int dimension;
         std::cin >> dimension;
+        // 排序需要全部设备都在容器中
+        try {
+            materializeMapped();
+        } catch (const std::exception &e) {
+            LOG_ALERT_SYS("快照中的设备无法创建: " + std::string(e.what()));
+            std::cout << "快照中的设备无法创建: " << e.what() << std::endl;
+        }
         sensors->sortDevices(dimension);
         lights->sortDevices(dimension);
         airConditioners->sortDevices(dimension);
@@ -158,6 +407,7 @@ void Room::showDevices() {
     json j = {{"Sensors", *sensors},
               {"Lights", *lights},
               {"AirConditioners", *airConditioners}};
+    appendMapped(j);
     std::cout << j.dump(4) << std::endl;
 }
 
@@ -170,8 +420,26 @@ void Room::findDevice() {
 
     LOG_INFO_SYS("查找设备ID: " + std::to_string(id));
 
-    bool found = sensors->findDevice(id) || lights->findDevice(id) ||
-                 airConditioners->findDevice(id);
+    bool found = false;
+    auto it = deviceDirectory.find(id);
+    if (it != deviceDirectory.end()) {
+        switch (it->second) {
+        case DeviceType::Sensor:
+            found = sensors->findDevice(id);
+            break;
+        case DeviceType::Light:
+            found = lights->findDevice(id);
+            break;
+        case DeviceType::AirConditioner:
+            found = airConditioners->findDevice(id);
+            break;
+        }
+    } else if (mapped && mapped->contains(id)) {
+        // 只读访问直接取映射的记录，不创建设备对象
+        std::cout << "Found device with id " << id << "\n";
+        std::cout << mapped->deviceJson(id).dump(4) << "\n";
+        found = true;
+    }
 
     if (!found) {
         LOG_INFO_SYS("未找到设备ID: " + std::to_string(id));
@@ -190,14 +458,49 @@ void Room::findDevice() {
 void Room::removeDevice() {
     LOG_INFO_SYS("开始删除设备");
     std::cout << "Remove device\n";
-    std::cout << "请输入设备ID: \n";
+    std::cout << "请输入设备ID(多个ID以空格分隔): \n";
+    std::string line;
+    std::cin >> std::ws;
+    std::getline(std::cin, line);
+    std::istringstream in(line);
+    std::vector<int> ids;
     int id;
-    std::cin >> id;
+    while (in >> id) {
+        ids.push_back(id);
+    }
+    if (ids.empty()) {
+        LOG_INFO_SYS("无效的设备ID: " + line);
+        std::cout << "无效的设备ID" << std::endl;
+        return;
+    }
+    if (ids.size() > 1) {
+        int removed = removeDevices(ids);
+        std::cout << "共删除 " << removed << " 个设备" << std::endl;
+        return;
+    }
+    id = ids.front();
 
     LOG_INFO_SYS("删除设备ID: " + std::to_string(id));
 
-    bool found = sensors->removeDevice(id) || lights->removeDevice(id) ||
-                 airConditioners->removeDevice(id);
+    bool found = false;
+    auto it = deviceDirectory.find(id);
+    if (it != deviceDirectory.end()) {
+        switch (it->second) {
+        case DeviceType::Sensor:
+            found = sensors->removeDevice(id);
+            break;
+        case DeviceType::Light:
+            found = lights->removeDevice(id);
+            break;
+        case DeviceType::AirConditioner:
+            found = airConditioners->removeDevice(id);
+            break;
+        }
+        deviceDirectory.erase(it);
+    } else if (mapped && mapped->contains(id)) {
+        mapped->detach(id);
+        found = true;
+    }
 
     if (!found) {
         LOG_INFO_SYS("未找到要删除的设备ID: " + std::to_string(id));
@@ -207,22 +510,73 @@ void Room::removeDevice() {
     }
 }
 
+// 批量删除设备：按设备目录分组后每个容器只整理一次
+int Room::removeDevices(const std::vector<int> &ids) {
+    std::vector<int> sensorIds, lightIds, acIds;
+    int detached = 0;
+    for (int id : ids) {
+        auto it = deviceDirectory.find(id);
+        if (it == deviceDirectory.end()) {
+            if (mapped && mapped->contains(id)) {
+                mapped->detach(id);
+                ++detached;
+            }
+            continue;
+        }
+        switch (it->second) {
+        case DeviceType::Sensor:
+            sensorIds.push_back(id);
+            break;
+        case DeviceType::Light:
+            lightIds.push_back(id);
+            break;
+        case DeviceType::AirConditioner:
+            acIds.push_back(id);
+            break;
+        }
+        deviceDirectory.erase(it);
+    }
+
+    int removed = detached + sensors->removeDevices(sensorIds) +
+                  lights->removeDevices(lightIds) +
+                  airConditioners->removeDevices(acIds);
+    LOG_INFO_SYS("批量删除设备完成，共删除 " + std::to_string(removed) + " 个");
+    return removed;
+}
+
 void Room::saveDevices() {
     LOG_INFO_SYS("开始保存设备信息");
     std::cout << "Save devices\n";
-    std::cout << "请输入想要保存的文件名称(无后缀): \n";
+    std::cout << "请输入想要保存的文件名称(不带后缀时保存为 .json，"
+                 "也可带 .cbor/.msgpack/.bson/.ubj 或二进制快照 .hsinv 后缀): \n";
     std::string filename;
     std::cin >> filename;
 
-    std::string json_path = "../data/" + filename + ".json";
+    if (isSnapshotName(filename)) {
+        std::string path = "../data/" + filename;
+        LOG_INFO_SYS("保存设备快照到文件: " + path);
+        try {
+            saveSnapshot(path);
+        } catch (const std::exception &e) {
+            LOG_ALERT_SYS("设备快照保存失败: " + std::string(e.what()));
+            std::cout << "设备快照保存失败: " << e.what() << std::endl;
+            return;
+        }
+        LOG_INFO_SYS("设备信息保存成功");
+        return;
+    }
+
+    DocumentFormat format;
+    std::string json_path = resolveDocumentPath("../data/", filename, format);
     LOG_INFO_SYS("保存设备信息到文件: " + json_path);
 
     json j = {{"Sensors", *sensors},
               {"Lights", *lights},
               {"AirConditioners", *airConditioners}};
+    appendMapped(j);
 
-    std::ofstream ofs(json_path);
-    ofs << j.dump(4);
+    std::ofstream ofs(json_path, std::ios::binary);
+    writeDocument(ofs, j, format);
     ofs.close();
 
     LOG_INFO_SYS("设备信息保存成功");
@@ -232,6 +586,15 @@ void Room::roomSimulation() {
     LOG_INFO_SYS("开始智能场景模拟");
     std::cout << "Scene simulation\n";
 
+    // 模拟线程直接扫描容器，映射清单中的设备需要先全部创建
+    try {
+        materializeMapped();
+    } catch (const std::exception &e) {
+        LOG_ALERT_SYS("快照中的设备无法创建: " + std::string(e.what()));
+        std::cout << "快照中的设备无法创建: " << e.what() << std::endl;
+        return;
+    }
+
     // 检查是否有设备
     if (sensors->getSize() == 0 && lights->getSize() == 0 &&
         airConditioners->getSize() == 0) {
@@ -242,19 +605,21 @@ void Room::roomSimulation() {
 
     // 创建场景模拟对象
     std::cout << "正在创建智能场景模拟对象..." << std::endl;
-    SceneSimulation *sceneSimulation = new SceneSimulation(this);
+    auto sceneSimulation = std::make_unique<SceneSimulation>(this);
+    sceneSimulation->setThreadPool(getThreadPool());
     std::cout << "智能场景模拟对象创建成功" << std::endl;
 
     // 加载环境配置文件
-    std::cout << "请输入你要加载的配置文件名称(data文件夹里): \n";
+    std::cout << "请输入你要加载的配置文件名称(data文件夹里，不带后缀时读取 .json): \n";
     std::string filename;
     std::cin >> filename;
-    std::string json_path = "../data/" + filename + ".json";
+    DocumentFormat format;
+    std::string json_path = resolveDocumentPath("../data/", filename, format);
     LOG_INFO_SYS("尝试加载环境配置文件: " + json_path);
     sceneSimulation->loadEnvironmentConfig(json_path);
 
     std::cout << "开始智能场景模拟..." << std::endl;
-    std::cout << "模拟将使用多线程控制不同类型的设备" << std::endl;
+    std::cout << "模拟按虚拟时间推进，各类设备按固定顺序更新" << std::endl;
     std::cout << "自动化规则和紧急事件处理已启用" << std::endl;
     std::cout << "将自动触发预设的突发事件" << std::endl;
 
@@ -272,20 +637,12 @@ void Room::changeDevice(int id) {
 
     LOG_INFO_SYS("修改设备ID: " + std::to_string(id));
 
-    bool found = sensors->findDevice(id) || lights->findDevice(id) ||
-                 airConditioners->findDevice(id);
+    Device *device = lookupDevice(id);
 
-    if (!found) {
+    if (!device) {
         LOG_INFO_SYS("未找到要修改的设备ID: " + std::to_string(id));
         std::cout << "未找到设备" << std::endl;
     } else {
-        Device *device = sensors->getDevice(id);
-        if (!device) {
-            device = lights->getDevice(id);
-        }
-        if (!device) {
-            device = airConditioners->getDevice(id);
-        }
         if (currentUser->canChangeDevice(device)) {
             LOG_INFO_SYS(
                 "当前用户可以修改设备ID: " + std::to_string(id) +
@@ -325,19 +682,19 @@ void Room::changeUser() {
     std::cin >> user_id;
     switch (user_id) {
     case 0:
-        currentUser = admin;
+        currentUser = admin.get();
         break;
     case 1:
-        currentUser = lightAdmin;
+        currentUser = lightAdmin.get();
         break;
     case 2:
-        currentUser = sensorAdmin;
+        currentUser = sensorAdmin.get();
         break;
     case 3:
-        currentUser = airConditionerAdmin;
+        currentUser = airConditionerAdmin.get();
         break;
     case 4:
-        currentUser = visitor;
+        currentUser = visitor.get();
         break;
     default:
         break;
@@ -357,6 +714,7 @@ void menu() {
     std::cout << "6 ---- 删除指定ID的设备" << std::endl;
     std::cout << "7 ---- 保存所有设备信息至文件中" << std::endl;
     std::cout << "8 --- 智能场景模拟" << std::endl;
+    std::cout << "9 ---- 多户住宅批量模拟" << std::endl;
     std::cout << "Q ---- 退出" << std::endl;
     std::cout << "==========================" << std::endl;
     std::cout << "请选择：" << std::endl;
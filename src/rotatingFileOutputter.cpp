@@ -0,0 +1,202 @@
+#include "rotatingFileOutputter.h"
+#include <cstdio>
+#include <utility>
+#ifdef HOMESPHERE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+RotatingFileOutputter::RotatingFileOutputter(const std::string &path,
+                                             RotationPolicy policy)
+    : path(path), policy(policy), fileBytes(0), nextArchive(1),
+      stopping(false) {
+    std::size_t slash = path.find_last_of("/\\");
+    std::size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos &&
+        (slash == std::string::npos || dot > slash + 1)) {
+        stem = path.substr(0, dot);
+        extension = path.substr(dot);
+    } else {
+        stem = path;
+    }
+    if (!compressionAvailable()) {
+        this->policy.compress = false;
+    }
+    open();
+    compressor = std::thread(&RotatingFileOutputter::compressorLoop, this);
+}
+
+RotatingFileOutputter::~RotatingFileOutputter() {
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        writeBuffer();
+        fileStream.close();
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_one();
+    compressor.join();
+}
+
+bool RotatingFileOutputter::compressionAvailable() {
+#ifdef HOMESPHERE_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RotatingFileOutputter::open() {
+    fileStream.open(path, std::ios::app | std::ios::binary);
+    fileBytes = 0;
+    if (fileStream.is_open()) {
+        fileStream.seekp(0, std::ios::end);
+        std::streamoff size = fileStream.tellp();
+        fileBytes = size > 0 ? std::size_t(size) : 0;
+    }
+    openedAt = std::chrono::steady_clock::now();
+}
+
+void RotatingFileOutputter::write(const std::string &message) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    append(message);
+    if (!policy.buffered) {
+        writeBuffer();
+    }
+}
+
+void RotatingFileOutputter::writeBatch(const std::vector<std::string> &messages) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    for (auto &message : messages) {
+        append(message);
+    }
+    if (!policy.buffered) {
+        writeBuffer();
+    }
+}
+
+void RotatingFileOutputter::flush() {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    writeBuffer();
+}
+
+void RotatingFileOutputter::append(const std::string &message) {
+    rotateIfNeeded();
+    buffer += message;
+    buffer += '\n';
+    fileBytes += message.size() + 1;
+    if (buffer.size() >= policy.bufferBytes) {
+        writeBuffer();
+    }
+}
+
+void RotatingFileOutputter::writeBuffer() {
+    if (buffer.empty()) {
+        return;
+    }
+    if (fileStream.is_open()) {
+        fileStream.write(buffer.data(), std::streamsize(buffer.size()));
+        fileStream.flush();
+    }
+    buffer.clear();
+}
+
+void RotatingFileOutputter::rotateIfNeeded() {
+    // 空文件不滚动，避免产生空的归档段
+    if (fileBytes == 0) {
+        return;
+    }
+    bool tooLarge = policy.maxBytes > 0 && fileBytes >= policy.maxBytes;
+    bool tooOld = policy.maxAge.count() > 0 &&
+                  std::chrono::steady_clock::now() - openedAt >= policy.maxAge;
+    if (tooLarge || tooOld) {
+        rotate();
+    }
+}
+
+void RotatingFileOutputter::rotate() {
+    writeBuffer();
+    fileStream.close();
+    std::string archive = stem + "." + std::to_string(nextArchive++) + extension;
+    bool renamed = std::rename(path.c_str(), archive.c_str()) == 0;
+    open();
+    if (!renamed) {
+        return;
+    }
+
+    std::vector<ArchiveJob> newJobs;
+    if (policy.compress) {
+        newJobs.push_back({archive, false});
+    }
+    archives.push_back(archive);
+    while (policy.maxArchives > 0 && int(archives.size()) > policy.maxArchives) {
+        newJobs.push_back({archives.front(), true});
+        archives.pop_front();
+    }
+    if (newJobs.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        for (auto &job : newJobs) {
+            jobs.push_back(std::move(job));
+        }
+    }
+    jobReady.notify_one();
+}
+
+#ifdef HOMESPHERE_HAVE_ZLIB
+// 先写入 .gz.tmp，完成后再改名，中途退出不会留下不完整的 .gz
+static bool gzipFile(const std::string &source) {
+    std::string target = source + ".gz";
+    std::string temporary = target + ".tmp";
+    std::FILE *in = std::fopen(source.c_str(), "rb");
+    if (in == nullptr) {
+        return false;
+    }
+    gzFile out = gzopen(temporary.c_str(), "wb6");
+    if (out == nullptr) {
+        std::fclose(in);
+        return false;
+    }
+    std::vector<char> chunk(1 << 16);
+    bool ok = true;
+    std::size_t n;
+    while (ok && (n = std::fread(chunk.data(), 1, chunk.size(), in)) > 0) {
+        ok = gzwrite(out, chunk.data(), unsigned(n)) == int(n);
+    }
+    ok = ok && !std::ferror(in);
+    std::fclose(in);
+    ok = gzclose(out) == Z_OK && ok;
+    if (!ok || std::rename(temporary.c_str(), target.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    std::remove(source.c_str());
+    return true;
+}
+#endif
+
+void RotatingFileOutputter::compressorLoop() {
+    std::unique_lock<std::mutex> lock(jobMutex);
+    while (true) {
+        jobReady.wait(lock, [this]() { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            return; // stopping，且队列已清空
+        }
+        ArchiveJob job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        if (job.remove) {
+            // 压缩失败时归档段保持未压缩，两种文件名都尝试删除
+            std::remove(job.archive.c_str());
+            std::remove((job.archive + ".gz").c_str());
+        } else {
+#ifdef HOMESPHERE_HAVE_ZLIB
+            gzipFile(job.archive);
+#endif
+        }
+        lock.lock();
+    }
+}
@@ -1,18 +1,90 @@
 #include "sensor.h"
 #include "common.h"
+#include "seqLock.h"
 #include <iostream>
 
-double Sensor::getTemperature() const { return temperature; }
+std::atomic<unsigned> &Sensor::sequence() {
+    return column.block ? column.block->sequence[column.index]
+                        : readingSequence;
+}
 
-double Sensor::getHumidity() const { return humidity; }
+const std::atomic<unsigned> &Sensor::sequence() const {
+    return column.block ? column.block->sequence[column.index]
+                        : readingSequence;
+}
 
-double Sensor::getCO2_Concentration() const { return CO2_Concentration; }
+double Sensor::getTemperature() const {
+    return field(TEMPERATURE_FIELD, temperature)
+        .load(std::memory_order_relaxed);
+}
 
-void Sensor::setTemperature(double temperature) { this->temperature = temperature; }
+double Sensor::getHumidity() const {
+    return field(HUMIDITY_FIELD, humidity).load(std::memory_order_relaxed);
+}
 
-void Sensor::setHumidity(double humidity) { this->humidity = humidity; }
+double Sensor::getCO2_Concentration() const {
+    return field(CO2_FIELD, CO2_Concentration).load(std::memory_order_relaxed);
+}
 
-void Sensor::setCO2_Concentration(double CO2_Concentration) { this->CO2_Concentration = CO2_Concentration; }
+SensorReadings Sensor::getReadings() const {
+    SensorReadings readings;
+    unsigned start;
+    do {
+        start = seqReadBegin(sequence());
+        readings.temperature = getTemperature();
+        readings.humidity = getHumidity();
+        readings.CO2_Concentration = getCO2_Concentration();
+    } while (seqReadRetry(sequence(), start));
+    return readings;
+}
+
+void Sensor::setTemperature(double temperature) {
+    seqWriteBegin(sequence());
+    field(TEMPERATURE_FIELD, this->temperature)
+        .store(temperature, std::memory_order_relaxed);
+    seqWriteEnd(sequence());
+}
+
+void Sensor::setHumidity(double humidity) {
+    seqWriteBegin(sequence());
+    field(HUMIDITY_FIELD, this->humidity)
+        .store(humidity, std::memory_order_relaxed);
+    seqWriteEnd(sequence());
+}
+
+void Sensor::setCO2_Concentration(double CO2_Concentration) {
+    seqWriteBegin(sequence());
+    field(CO2_FIELD, this->CO2_Concentration)
+        .store(CO2_Concentration, std::memory_order_relaxed);
+    seqWriteEnd(sequence());
+}
+
+void Sensor::setReadings(const SensorReadings &readings) {
+    seqWriteBegin(sequence());
+    field(TEMPERATURE_FIELD, temperature)
+        .store(readings.temperature, std::memory_order_relaxed);
+    field(HUMIDITY_FIELD, humidity)
+        .store(readings.humidity, std::memory_order_relaxed);
+    field(CO2_FIELD, CO2_Concentration)
+        .store(readings.CO2_Concentration, std::memory_order_relaxed);
+    seqWriteEnd(sequence());
+}
+
+void Sensor::saveFieldsToColumns() {
+    SensorReadings readings{temperature.load(std::memory_order_relaxed),
+                            humidity.load(std::memory_order_relaxed),
+                            CO2_Concentration.load(std::memory_order_relaxed)};
+    column.block->sequence[column.index].store(0, std::memory_order_relaxed);
+    setReadings(readings); // 已绑定，写入列中
+}
+
+void Sensor::loadFieldsFromColumns() {
+    SensorReadings readings = getReadings(); // 仍处于绑定状态，读取列中的值
+    temperature.store(readings.temperature, std::memory_order_relaxed);
+    humidity.store(readings.humidity, std::memory_order_relaxed);
+    CO2_Concentration.store(readings.CO2_Concentration,
+                            std::memory_order_relaxed);
+}
 
 DeviceType Sensor::getDeviceType() const { return DeviceType::Sensor; }
 
@@ -21,16 +93,16 @@ void Sensor::update() { return; }
 json Sensor::toJson() const {
     return {{"id", id},
             {"name", name},
-            {"priorityLevel", priorityLevel},
-            {"powerConsumption", powerConsumption},
-            {"updateFrequency", updateFrequency},
-            {"temperature", temperature},
-            {"humidity", humidity},
-            {"CO2_Concentration", CO2_Concentration}};
+            {"priorityLevel", getPriorityLevel()},
+            {"powerConsumption", getPowerConsumption()},
+            {"updateFrequency", getUpdateFrequency()},
+            {"temperature", getTemperature()},
+            {"humidity", getHumidity()},
+            {"CO2_Concentration", getCO2_Concentration()}};
 }
 
     Device *SensorFactory::createDevice() {
-    Sensor *sensor = new Sensor("Sensor", 0, 2.0);
+    Sensor *sensor = pool.create("Sensor", 0, 2.0);
     return sensor;
 }
 
@@ -78,10 +150,29 @@ Device *SensorFactory::createDevice(const json &param) {
     // 获取updateFrequency，如果不存在则使用默认值
     int updateFrequency = param.value("updateFrequency", 1000);
 
-    return new Sensor(name, priorityLevel, powerConsumption, temperature,
-                      humidity, co2);
+    return pool.create(name, priorityLevel, powerConsumption, temperature,
+                       humidity, co2, updateFrequency);
+}
+
+Sensor *SensorFactory::create(const std::string &name, int priorityLevel,
+                             double powerConsumption,
+                             const SensorReadings &readings,
+                             int updateFrequency) {
+    return pool.create(name, priorityLevel, powerConsumption,
+                       readings.temperature, readings.humidity,
+                       readings.CO2_Concentration, updateFrequency);
+}
+
+void SensorFactory::destroyDevice(Device *device) {
+    if (pool.owns(device)) {
+        pool.destroy(static_cast<Sensor *>(device));
+    } else {
+        delete device;
+    }
 }
 
+void SensorFactory::reserve(int count) { pool.reserve(count); }
+
 void SensorContainer::changeDevice(int id) {
     Sensor *sensor = dynamic_cast<Sensor *>(getDevice(id));
     if (sensor) {
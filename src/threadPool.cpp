@@ -0,0 +1,175 @@
+#include "threadPool.h"
+#include <algorithm>
+#include <chrono>
+
+// 当前线程所属的线程池及其队列下标，不是工作线程时 currentPool 为空
+static thread_local const ThreadPool *currentPool = nullptr;
+static thread_local unsigned currentWorker = 0;
+
+ThreadPool::ThreadPool(unsigned workers)
+    : queued(0), nextQueue(0), stopping(false), waiting(0) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < workers; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < workers; ++i) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    idle.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    unsigned index = currentPool == this
+                         ? currentWorker
+                         : nextQueue.fetch_add(1) % unsigned(queues.size());
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    {
+        // 在 idleMutex 下通知，避免工作线程检查完条件后错过唤醒
+        std::lock_guard<std::mutex> lock(idleMutex);
+    }
+    idle.notify_one();
+    notifyWaiters();
+}
+
+void ThreadPool::notifyWaiters() {
+    // 等待方先增加 waiting 再检查条件，这里读到 0 时它必然能看到新的状态
+    if (waiting == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+    }
+    progress.notify_all();
+}
+
+bool ThreadPool::runOne(unsigned self) {
+    Task task;
+    unsigned n = unsigned(queues.size());
+    for (unsigned k = 0; k < n && !task; ++k) {
+        Queue &queue = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        // 自己的队列后进先出，窃取时先进先出
+        if (k == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    queued.fetch_sub(1);
+    task();
+    notifyWaiters();
+    return true;
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idle.wait(lock, [this]() { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::waitUntil(const std::function<bool()> &done) {
+    unsigned self = currentPool == this ? currentWorker : 0;
+    while (!done()) {
+        if (runOne(self)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idleMutex);
+        ++waiting;
+        progress.wait_for(lock, std::chrono::milliseconds(1),
+                          [this, &done]() { return queued > 0 || done(); });
+        --waiting;
+    }
+}
+
+TaskGraph::TaskId TaskGraph::add(ThreadPool::Task task,
+                                 const std::vector<TaskId> &dependencies) {
+    TaskId id = nodes.size();
+    auto node = std::make_unique<Node>();
+    node->task = std::move(task);
+    node->dependencies = int(dependencies.size());
+    nodes.push_back(std::move(node));
+    for (TaskId dependency : dependencies) {
+        nodes[dependency]->dependents.push_back(id);
+    }
+    return id;
+}
+
+void TaskGraph::run(ThreadPool &pool) {
+    error = nullptr;
+    unfinished = nodes.size();
+    for (auto &node : nodes) {
+        node->remaining = node->dependencies;
+        node->skipped = false;
+    }
+    for (TaskId id = 0; id < nodes.size(); ++id) {
+        if (nodes[id]->dependencies == 0) {
+            launch(pool, id);
+        }
+    }
+    pool.waitUntil([this]() { return unfinished == 0; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGraph::launch(ThreadPool &pool, TaskId id) {
+    pool.submit([this, &pool, id]() {
+        Node &node = *nodes[id];
+        bool failed = node.skipped;
+        if (!failed) {
+            try {
+                node.task();
+            } catch (...) {
+                failed = true;
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        for (TaskId dependent : node.dependents) {
+            // 跳过的任务同样提交，由它把跳过标记传给自己的后继并完成计数
+            if (failed) {
+                nodes[dependent]->skipped = true;
+            }
+            if (nodes[dependent]->remaining.fetch_sub(1) == 1) {
+                launch(pool, dependent);
+            }
+        }
+        // 最后才减少计数，此后 run() 可能返回，不能再访问 this
+        unfinished.fetch_sub(1);
+    });
+}
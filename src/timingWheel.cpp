@@ -0,0 +1,42 @@
+#include "timingWheel.h"
+
+TimingWheel::TimingWheel(int slots) : slots(slots), offsets(slots + 1, 0) {}
+
+void TimingWheel::clear() {
+    pending.clear();
+    items.clear();
+    offsets.assign(slots + 1, 0);
+}
+
+void TimingWheel::add(int slot, std::size_t item) {
+    if (slot < 0 || slot >= slots) {
+        return;
+    }
+    pending.emplace_back(slot, item);
+}
+
+void TimingWheel::build() {
+    // 计数排序：先统计各槽条目数得到起始位置，再按登记顺序填入
+    offsets.assign(slots + 1, 0);
+    for (auto &entry : pending) {
+        ++offsets[entry.first + 1];
+    }
+    for (int i = 0; i < slots; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    items.resize(pending.size());
+    std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (auto &entry : pending) {
+        items[cursor[entry.first]++] = entry.second;
+    }
+    pending.clear();
+    pending.shrink_to_fit();
+}
+
+TimingWheel::Bucket TimingWheel::at(int slot) const {
+    if (slot < 0 || slot >= slots) {
+        return Bucket(nullptr, nullptr);
+    }
+    return Bucket(items.data() + offsets[slot],
+                  items.data() + offsets[slot + 1]);
+}
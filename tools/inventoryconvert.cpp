@@ -0,0 +1,76 @@
+// 设备清单格式转换工具：在 JSON/CBOR/MessagePack/BSON/UBJSON 清单与
+// 二进制快照（.hsinv）之间互相转换
+// 用法: homesphere-invconvert <输入文件> <输出文件>
+// 以 .hsinv 结尾的文件按快照处理，其余按后缀选择格式（见 documentFormat.h），
+// 无法识别的后缀按文本 JSON 处理。转换经过设备工厂，取值检查与程序内导入
+// 相同；输出与 Room::saveDevices 的格式一致
+#include "inventorySnapshot.h"
+#include "parallelImport.h"
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static bool isSnapshotName(const std::string &filename) {
+    const std::string suffix = ".hsinv";
+    return filename.size() > suffix.size() &&
+           filename.compare(filename.size() - suffix.size(), suffix.size(),
+                            suffix) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0]
+                  << " <input> <output>\n"
+                  << "formats: .json .cbor .msgpack .bson .ubj .hsinv\n";
+        return 2;
+    }
+    std::string input = argv[1];
+    std::string output = argv[2];
+
+    // 转换工具只顺序读写，设备数据保存在对象内即可
+    SensorContainer sensors(new SensorFactory());
+    LightContainer lights(new LightFactory());
+    AirConditionerContainer airConditioners(new AirConditionerFactory());
+    try {
+        InventoryCounts counts;
+        if (isSnapshotName(input)) {
+            counts = loadInventorySnapshot(input, sensors, lights,
+                                           airConditioners);
+        } else {
+            DocumentFormat format = DocumentFormat::Json;
+            documentFormatFromName(input, format);
+            std::ifstream in(input, std::ios::binary);
+            if (!in.is_open()) {
+                std::cerr << "cannot open " << input << "\n";
+                return 1;
+            }
+            ThreadPool pool;
+            counts = importInventory(in, format, sensors, lights,
+                                     airConditioners, pool);
+        }
+
+        if (isSnapshotName(output)) {
+            saveInventorySnapshot(output, sensors, lights, airConditioners);
+        } else {
+            DocumentFormat format = DocumentFormat::Json;
+            documentFormatFromName(output, format);
+            std::ofstream out(output, std::ios::binary);
+            if (!out.is_open()) {
+                std::cerr << "cannot open " << output << "\n";
+                return 1;
+            }
+            json j = {{"Sensors", sensors},
+                      {"Lights", lights},
+                      {"AirConditioners", airConditioners}};
+            writeDocument(out, j, format);
+        }
+        std::cout << "sensors: " << counts.sensors
+                  << ", lights: " << counts.lights
+                  << ", air conditioners: " << counts.airConditioners << "\n";
+    } catch (const std::exception &e) {
+        std::cerr << input << ": " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+// 二进制日志解码工具：把 BinaryLogWriter 写出的文件还原为文本日志
+// 用法: homesphere-logdecode <日志文件> [输出文件]，不给输出文件时写到标准输出
+#include "binaryLog.h"
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <log.hslog> [output.log]\n";
+        return 2;
+    }
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "cannot open " << argv[1] << "\n";
+        return 1;
+    }
+    std::ofstream file;
+    if (argc > 2) {
+        file.open(argv[2]);
+        if (!file.is_open()) {
+            std::cerr << "cannot open " << argv[2] << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = argc > 2 ? file : std::cout;
+    std::string error;
+    if (!decodeBinaryLog(in, out, &error)) {
+        std::cerr << argv[1] << ": " << error << "\n";
+        return 1;
+    }
+    return 0;
+}